@@ -0,0 +1,278 @@
+// draw cost of frontends in headless ImGui context (font atlas is built, nothing is rendered):
+// Hotline::Draw with settled and changing query, DrawVariants alone and ArgProviderBase::Provide of
+// preset and search providers. Per measured frame it reports CPU time of whole frame and of frontend
+// call, vertices, indices, draw commands, and allocations done through ImGui and through operator new.
+//   hotline_frontend_bench [--results N] [--frames F] [--actions A] [--query Q]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <imgui.h>
+
+#include "ActionSet.h"
+#include "ActionSetGroup.h"
+#include "ArgProvider.h"
+#include "Hotline.h"
+
+namespace {
+    size_t heapAllocations = 0;
+    size_t imguiAllocations = 0;
+
+    void *ImGuiAlloc(size_t size, void *) {
+        imguiAllocations++;
+        return std::malloc(size);
+    }
+
+    void ImGuiFree(void *ptr, void *) {
+        std::free(ptr);
+    }
+}
+
+// counts every allocation of hotline and std containers, ImGui ones go through ImGuiAlloc instead
+void *operator new(size_t size) {
+    heapAllocations++;
+    if (void *ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace {
+    using namespace hotline;
+    using Clock = std::chrono::steady_clock;
+
+    struct FrameStats {
+        double frameUs = 0;
+        double frontendUs = 0;
+        double vertices = 0;
+        double indices = 0;
+        double drawCommands = 0;
+        double drawLists = 0;
+        double imguiAllocations = 0;
+        double heapAllocations = 0;
+    };
+
+    // exposes protected parts of Hotline, so variant list can be measured without input and search
+    class BenchHotline : public Hotline {
+    public:
+        // same placement as Draw, window helpers of Hotline are private
+        void DrawVariantsWindow(ActionSetGroup &sets) {
+            const ImGuiIO &io = ImGui::GetIO();
+            ImGui::SetNextWindowPos({io.DisplaySize.x * hotlineConfig.windowPos.x,
+                                     io.DisplaySize.y * hotlineConfig.windowPos.y}, ImGuiCond_Always,
+                                    hotlineConfig.windowPivot);
+            ImGui::SetNextWindowSize({io.DisplaySize.x * hotlineConfig.windowSize.x,
+                                      io.DisplaySize.y * hotlineConfig.windowSize.y});
+            ImGui::Begin("HotlineWindow", nullptr, hotlineConfig.windowFlags);
+            ImGui::SetWindowFontScale(hotlineConfig.windowFontScale * hotlineConfig.scaleFactor);
+            DrawVariants(sets);
+            ImGui::End();
+        }
+    };
+
+    // names of 1 to 8 CamelCase words, so rows have different lengths and match runs
+    std::string MakeName(std::mt19937 &random) {
+        static const char *words[] = {"Open", "Close", "Scene", "Asset", "Export", "Import", "Mesh", "Shader",
+                                      "Texture", "Selection", "Toggle", "Editor", "Viewport", "Settings", "Reload",
+                                      "Sound", "Animation", "Layer", "Prefab", "Lightmap", "Show", "Hide", "Debug"};
+        const int wordCount = std::uniform_int_distribution<int>(1, 8)(random);
+        std::uniform_int_distribution<size_t> word(0, std::size(words) - 1);
+        std::string name;
+        for (int i = 0; i < wordCount; i++) {
+            name += words[word(random)];
+        }
+        return name + std::to_string(random() % 1000);
+    }
+
+    void BeginFrame() {
+        ImGui::NewFrame();
+    }
+
+    void EndFrame(FrameStats &stats) {
+        ImGui::Render();
+        const ImDrawData *drawData = ImGui::GetDrawData();
+        stats.vertices += drawData->TotalVtxCount;
+        stats.indices += drawData->TotalIdxCount;
+        stats.drawLists += drawData->CmdListsCount;
+        for (int i = 0; i < drawData->CmdListsCount; i++) {
+            stats.drawCommands += drawData->CmdLists[i]->CmdBuffer.Size;
+        }
+    }
+
+    // runs warmup frames first, then averages measured ones. beforeFrame feeds input, draw is the measured call
+    FrameStats Measure(int frames, const std::function<void(int)> &beforeFrame, const std::function<void()> &draw) {
+        const int warmupFrames = 10;
+        FrameStats total;
+        for (int frame = -warmupFrames; frame < frames; frame++) {
+            if (beforeFrame) {
+                beforeFrame(frame + warmupFrames);
+            }
+            FrameStats stats;
+            const size_t heapBefore = heapAllocations;
+            const size_t imguiBefore = imguiAllocations;
+            const auto frameStart = Clock::now();
+            BeginFrame();
+            const auto frontendStart = Clock::now();
+            draw();
+            const auto frontendEnd = Clock::now();
+            EndFrame(stats);
+            const auto frameEnd = Clock::now();
+            if (frame < 0) {
+                continue;
+            }
+            stats.frameUs = std::chrono::duration<double, std::micro>(frameEnd - frameStart).count();
+            stats.frontendUs = std::chrono::duration<double, std::micro>(frontendEnd - frontendStart).count();
+            stats.heapAllocations = static_cast<double>(heapAllocations - heapBefore);
+            stats.imguiAllocations = static_cast<double>(imguiAllocations - imguiBefore);
+            total.frameUs += stats.frameUs;
+            total.frontendUs += stats.frontendUs;
+            total.vertices += stats.vertices;
+            total.indices += stats.indices;
+            total.drawCommands += stats.drawCommands;
+            total.drawLists += stats.drawLists;
+            total.imguiAllocations += stats.imguiAllocations;
+            total.heapAllocations += stats.heapAllocations;
+        }
+        const double count = std::max(frames, 1);
+        for (double *value: {&total.frameUs, &total.frontendUs, &total.vertices, &total.indices, &total.drawCommands,
+                             &total.drawLists, &total.imguiAllocations, &total.heapAllocations}) {
+            *value /= count;
+        }
+        return total;
+    }
+
+    void PrintHeader() {
+        std::printf("%-34s %9s %11s %9s %9s %9s %6s %12s %11s\n", "frontend", "frame us", "frontend us", "vertices",
+                    "indices", "draw cmds", "lists", "imgui allocs", "heap allocs");
+    }
+
+    void Print(const char *name, const FrameStats &stats) {
+        std::printf("%-34s %9.1f %11.1f %9.0f %9.0f %9.0f %6.1f %12.1f %11.1f\n", name, stats.frameUs,
+                    stats.frontendUs, stats.vertices, stats.indices, stats.drawCommands, stats.drawLists,
+                    stats.imguiAllocations, stats.heapAllocations);
+    }
+
+    // provider draws inside a window, as ProviderWindow does
+    template<typename Provider>
+    void DrawProvider(Provider &provider) {
+        const ImGuiIO &io = ImGui::GetIO();
+        ImGui::SetNextWindowPos({io.DisplaySize.x * 0.5f, io.DisplaySize.y * 0.5f}, ImGuiCond_Always, {0.5f, 0.5f});
+        ImGui::SetNextWindowSize({io.DisplaySize.x * 0.4f, io.DisplaySize.y * 0.4f});
+        ImGui::Begin("ArgProviderWindow", nullptr, argConfig.windowFlags);
+        provider.Provide();
+        ImGui::End();
+    }
+}
+
+int main(int argc, char **argv) {
+    size_t resultCount = 20;
+    int frames = 500;
+    size_t actionCount = 20000;
+    std::string query = "ose";
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const std::string_view arg = argv[i];
+        if (arg == "--results") {
+            resultCount = std::strtoull(argv[i + 1], nullptr, 10);
+        } else if (arg == "--frames") {
+            frames = std::atoi(argv[i + 1]);
+        } else if (arg == "--actions") {
+            actionCount = std::strtoull(argv[i + 1], nullptr, 10);
+        } else if (arg == "--query") {
+            query = argv[i + 1];
+        } else {
+            std::fprintf(stderr, "usage: %s [--results N] [--frames F] [--actions A] [--query Q]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    IMGUI_CHECKVERSION();
+    ImGui::SetMemoryAllocators(&ImGuiAlloc, &ImGuiFree);
+    ImGui::CreateContext();
+    ImGuiIO &io = ImGui::GetIO();
+    io.DisplaySize = {1920.f, 1080.f};
+    io.DeltaTime = 1.f / 60.f;
+    io.IniFilename = nullptr;
+    // no renderer backend, atlas only has to exist for text layout
+    unsigned char *pixels = nullptr;
+    int width = 0;
+    int height = 0;
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+
+    std::mt19937 random(42);
+    auto actions = std::make_shared<ActionSet>();
+    std::vector<std::pair<std::string, std::unique_ptr<BaseAction>>> entries;
+    for (size_t i = 0; i < actionCount; i++) {
+        std::string name = MakeName(random);
+        // every third action shows argument labels next to its name
+        if (i % 3 == 0) {
+            entries.emplace_back(name, MakeAction(name, [](int) {}, ArgProvider<int>("count")));
+        } else {
+            entries.emplace_back(name, MakeAction(name, []() {}));
+        }
+    }
+    actions->AddActions(entries);
+    ActionSetGroup sets;
+    sets.AddActionSet("bench", actions);
+
+    hotlineConfig.variantLimit = resultCount;
+    hotlineConfig.showRecentActions = false;
+    BenchHotline hotline;
+    hotline.SetExitCallback([]() {});
+
+    std::printf("%zu actions, query \"%s\", up to %zu results, %d frames\n", actionCount, query.c_str(), resultCount,
+                frames);
+    PrintHeader();
+
+    // query is typed one character per frame during warmup, measured frames only redraw results
+    const FrameStats settled = Measure(frames, [&](int frame) {
+        if (frame >= 2 && frame - 2 < static_cast<int>(query.size())) {
+            io.AddInputCharacter(static_cast<unsigned char>(query[frame - 2]));
+        }
+    }, [&]() { hotline.Draw(sets); });
+    Print("Hotline::Draw, settled query", settled);
+
+    // last character is erased and typed again, every frame searches and lays out new results
+    const FrameStats typing = Measure(frames, [&](int frame) {
+        const bool erase = frame % 2 == 0;
+        io.AddKeyEvent(ImGuiKey_Backspace, erase);
+        if (!erase) {
+            io.AddInputCharacter(static_cast<unsigned char>(query.back()));
+        }
+    }, [&]() { hotline.Draw(sets); });
+    Print("Hotline::Draw, typing", typing);
+    io.AddKeyEvent(ImGuiKey_Backspace, false);
+
+    const FrameStats variants = Measure(frames, nullptr, [&]() { hotline.DrawVariantsWindow(sets); });
+    Print("Hotline::DrawVariants", variants);
+
+    ArgProvider<int> presetProvider("count");
+    const FrameStats presets = Measure(frames, nullptr, [&]() { DrawProvider(presetProvider); });
+    Print("ArgProvider<int>::Provide", presets);
+
+    std::vector<std::string> values;
+    for (size_t i = 0; i < resultCount; i++) {
+        values.push_back(MakeName(random));
+    }
+    StringSearchArgProvider searchProvider("asset", values);
+    const FrameStats search = Measure(frames, nullptr, [&]() { DrawProvider(searchProvider); });
+    Print("StringSearchArgProvider::Provide", search);
+
+    ImGui::DestroyContext();
+    return 0;
+}
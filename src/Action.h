@@ -2,10 +2,16 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
+#include <tuple>
+
+#include "search/ArgumentCompletion.h"
+#include "search/StringPool.h"
 
 enum ActionStartResult {
     Success,
-    Failure
+    Failure,            // not enough arguments, they are left to provider frontend
+    InvalidArguments    // argument couldn't be parsed, action didn't run
 };
 
 enum ArgumentProvidingState {
@@ -16,11 +22,12 @@ enum ArgumentProvidingState {
     Cancelled
 };
 
-inline void FillArgumentName(std::vector<std::string> &argVector) {}
+inline void FillArgumentName(std::vector<std::string_view> &argVector) {}
 
+// labels are interned, actions with the same argument names share them. Released by ~Action
 template<typename T, typename... Args>
-void FillArgumentName(std::vector<std::string> &argVector, T &arg, Args &&... args) {
-    argVector.push_back(arg._name);
+void FillArgumentName(std::vector<std::string_view> &argVector, T &arg, Args &&... args) {
+    argVector.push_back(hotline::SharedStringPool().Intern(arg._name));
     FillArgumentName(argVector, args...);
 };
 
@@ -32,13 +39,13 @@ void ProcessArguments(ArgumentProvidingState &state, T &arg, Args &&... args) {
     state = arg.Provide();
 };
 
-inline void ProcessStringArguments(int idx, const std::vector<std::string> &stringArgs) {}
+inline bool ProcessStringArguments(int idx, const std::vector<std::string> &stringArgs) { return true; }
 
+// false as soon as one argument can't be parsed, later ones are left untouched
 template<typename T, typename... Args>
-void ProcessStringArguments(int idx, const std::vector<std::string> &stringArgs, T &arg,
+bool ProcessStringArguments(int idx, const std::vector<std::string> &stringArgs, T &arg,
                             Args &&... args) {
-    arg.ProvideFromString(stringArgs[idx]);
-    ProcessStringArguments(idx++, stringArgs, args...);
+    return arg.ProvideFromString(stringArgs[idx]) && ProcessStringArguments(idx + 1, stringArgs, args...);
 }
 
 inline void ResetArguments() {}
@@ -59,9 +66,13 @@ public:
 
     virtual ActionStartResult Start(const std::vector<std::string> &stringArgs) = 0;
 
-    virtual std::string &GetName() = 0;
+    // interned, see StringPool
+    virtual std::string_view GetName() const = 0;
+
+    virtual const std::vector<std::string_view> &GetArguments() const = 0;
 
-    virtual std::vector<std::string> &GetArguments() = 0;
+    // known values (presets) of argument by prefix, used for completion. Null if provider has none
+    virtual const hotline::PrefixIndex *GetArgumentValueIndex(size_t argIdx) = 0;
 };
 
 template<typename Func, typename... Ts>
@@ -71,7 +82,7 @@ public:
     template<typename FwdF, typename... FwdTs,
             typename = std::enable_if_t<(std::is_convertible_v<FwdTs &&, Ts> && ...)>>
     Action(const std::string &name, FwdF &&func, FwdTs &&... args)
-            : _name(name),
+            : _name(hotline::SharedStringPool().Intern(name)),
               _func(std::forward<FwdF>(func)),
               _args{std::forward<FwdTs>(args)...},
               _size(std::tuple_size_v<decltype(_args)>) {
@@ -79,16 +90,34 @@ public:
         std::apply(processor, _args);
     }
 
-    ~Action() override {}
+    Action(const Action &) = delete;
+    Action &operator=(const Action &) = delete;
+
+    ~Action() override {
+        hotline::SharedStringPool().Release(_name);
+        for (const auto label: _stringArgs) {
+            hotline::SharedStringPool().Release(label);
+        }
+    }
 
-    std::string &GetName() override {
+    std::string_view GetName() const override {
         return _name;
     }
 
-    std::vector<std::string> &GetArguments() override {
+    const std::vector<std::string_view> &GetArguments() const override {
         return _stringArgs;
     }
 
+    const hotline::PrefixIndex *GetArgumentValueIndex(size_t argIdx) override {
+        const hotline::PrefixIndex *values = nullptr;
+        size_t idx = 0;
+        auto processor = [&](auto &&... args) {
+            ((idx++ == argIdx ? (void) (values = args.GetValueIndex()) : (void) 0), ...);
+        };
+        std::apply(processor, _args);
+        return values;
+    }
+
     ArgumentProvidingState UpdateProviding() override {
         auto state = ArgumentProvidingState::Provided;
         auto processor = [&state](auto &&... args) { ((ProcessArguments(state, args)), ...); };
@@ -105,23 +134,23 @@ public:
 
     ActionStartResult Start(const std::vector<std::string> &stringArgs) override {
         if (_size <= stringArgs.size()) {
-            int idx = 0;
-            auto processor = [&](auto &&... args) { ((ProcessStringArguments(idx, stringArgs, args), idx++), ...); };
-            std::apply(processor, _args);
-            std::apply(_func, _args);
+            auto processor = [&](auto &&... args) { return ProcessStringArguments(0, stringArgs, args...); };
+            const bool parsed = std::apply(processor, _args);
+            if (parsed) {
+                std::apply(_func, _args);
+            }
 
             auto resetter = [](auto &&... args) { ((ResetArguments(args)), ...); };
             std::apply(resetter, _args);
-            // todo handle wrong argument providing
-            return ActionStartResult::Success;
+            return parsed ? ActionStartResult::Success : ActionStartResult::InvalidArguments;
         }
 
         return ActionStartResult::Failure;
     }
 
 private:
-    std::string _name;
-    std::vector<std::string> _stringArgs;
+    std::string_view _name;
+    std::vector<std::string_view> _stringArgs;
     Func _func;
     std::tuple<Ts...> _args;
     std::size_t _size;
@@ -3,15 +3,58 @@
 #include <imgui.h>
 
 #include "ActionSet.h"
+#include "TraceRecorder.h"
 
-hotline::ActionManager::ActionManager(std::shared_ptr<ActionSet> set)
-: _set(std::move(set)) {}
+hotline::ActionManager::ActionManager() = default;
+
+hotline::ActionManager::ActionManager(std::shared_ptr<ActionSet> set) : ActionManager() {
+	_sets.AddActionSet("default", std::move(set));
+}
+
+hotline::ActionManager::~ActionManager() {
+	// sets may be shared and outlive the arena
+	_sets.SetFrameResource(nullptr);
+}
+
+void hotline::ActionManager::AddActionSet(const std::string& name, std::shared_ptr<ActionSet> set, bool enabled) {
+	_sets.AddActionSet(name, std::move(set), enabled);
+}
+
+void hotline::ActionManager::SetActionSetEnabled(const std::string& name, bool enabled) {
+	_sets.SetActionSetEnabled(name, enabled);
+}
+
+bool hotline::ActionManager::IsActionSetEnabled(const std::string& name) const {
+	return _sets.IsActionSetEnabled(name);
+}
 
 void hotline::ActionManager::Update() {
-	auto state = _set->GetState();
+	HOTLINE_TRACE_SCOPE("frame", "ActionManager::Update");
+	_frameArena.Reset();
+	_sets.SetFrameResource(&_frameArena);
+	UpdateFrontends();
+	_sets.SetFrameResource(nullptr);
+}
+
+void hotline::ActionManager::UpdateFrontends() {
+	_sets.UpdateIndexBuild();
+#if defined(HOTLINE_COMMAND_SERVER)
+	if (_commandServer) {
+		_commandServer->Poll();
+	}
+#endif
+
+	auto state = _sets.GetState();
+#if defined(HOTLINE_TRACE)
+	if (state != _tracedState) {
+		_tracedState = state;
+		HOTLINE_TRACE_COUNTER("provider", "provider state", state);
+	}
+#endif
 	if (state == InProgress) {
 		assert(_providerFrontend);
-		_providerFrontend->Draw(*_set);
+		HOTLINE_TRACE_SCOPE("frontend", "draw provider frontend");
+		_providerFrontend->Draw(_sets);
 		return;
 	}
 
@@ -21,16 +64,17 @@ void hotline::ActionManager::Update() {
 	}
 
 	if (state != None) {
-		_set->Reset();
+		_sets.Reset();
 	}
 
 	if (_currentActionFrontend) {
-		_currentActionFrontend->Draw(*_set);
+		HOTLINE_TRACE_SCOPE("frontend", "draw action frontend");
+		_currentActionFrontend->Draw(_sets);
 	}
 }
 
 void hotline::ActionManager::EnableFrontend(const std::string& name) {
-	if (_set->GetState() == InProgress) return;
+	if (_sets.GetState() == InProgress) return;
 
 	const auto found = _actionFrontends.find(name);
 	assert(found != _actionFrontends.end());
@@ -44,7 +88,7 @@ void hotline::ActionManager::EnableFrontend(const std::string& name) {
 }
 
 void hotline::ActionManager::Close() {
-	if (_set->GetState() == InProgress) return;
+	if (_sets.GetState() == InProgress) return;
 
 	if (_currentActionFrontend) {
 		_currentActionFrontend->Reset();
@@ -62,4 +106,17 @@ void hotline::ActionManager::AddActionFrontend(const std::string& name, std::uni
 
 void hotline::ActionManager::SetProviderFrontend(std::unique_ptr<IProviderFrontend> frontend) {
 	_providerFrontend = std::move(frontend);
-}
\ No newline at end of file
+}
+
+#if defined(HOTLINE_COMMAND_SERVER)
+bool hotline::ActionManager::StartCommandServer(const std::string& socketPath) {
+	if (!_commandServer) {
+		_commandServer = std::make_unique<CommandServer>(_sets);
+	}
+	return _commandServer->Start(socketPath);
+}
+
+void hotline::ActionManager::StopCommandServer() {
+	_commandServer.reset();
+}
+#endif
@@ -3,24 +3,56 @@
 #include <memory>
 #include <string>
 
+#include "ActionSetGroup.h"
+#include "FrameArena.h"
 #include "IActionFrontend.h"
+#if defined(HOTLINE_COMMAND_SERVER)
+#include "CommandServer.h"
+#endif
 
 namespace hotline {
 	class ActionManager {
 	public:
-		explicit ActionManager(std::shared_ptr<ActionSet> set);
+		ActionManager();
+		explicit ActionManager(std::shared_ptr<ActionSet> set);    // added as "default" action set
+		~ActionManager();
 
+		// several sets (per tool/editor context) are searched together, disabled ones are skipped
+		void AddActionSet(const std::string& name, std::shared_ptr<ActionSet> set, bool enabled = true);
+		void SetActionSetEnabled(const std::string& name, bool enabled);
+		bool IsActionSetEnabled(const std::string& name) const;
+
+		// frame arena is reset first, memory taken from it during previous Update is reused. Sets search
+		// with the arena only during Update, searches from elsewhere use their own resources
 		void Update();
 		void EnableFrontend(const std::string& name);
 		void Close();
 
 		void AddActionFrontend(const std::string& name, std::unique_ptr<IActionFrontend> frontend);
 		void SetProviderFrontend(std::unique_ptr<IProviderFrontend> frontend);
+
+		// transient search and draw data of one Update, frontends reach it by ActionSetGroup::GetFrameResource
+		FrameArena& GetFrameArena() { return _frameArena; }
+
+#if defined(HOTLINE_COMMAND_SERVER)
+		// commands of external tools are executed at start of every Update, see CommandServer
+		bool StartCommandServer(const std::string& socketPath);
+		void StopCommandServer();
+#endif
 	private:
+		void UpdateFrontends();
+
 		std::map<std::string, std::unique_ptr<IActionFrontend>> _actionFrontends;
 		std::unique_ptr<IProviderFrontend> _providerFrontend;
 		IActionFrontend* _currentActionFrontend = nullptr;
 
-		std::shared_ptr<ActionSet> _set;
+		FrameArena _frameArena;
+		ActionSetGroup _sets;
+#if defined(HOTLINE_COMMAND_SERVER)
+		std::unique_ptr<CommandServer> _commandServer;
+#endif
+#if defined(HOTLINE_TRACE)
+		ArgumentProvidingState _tracedState = None;  // provider state is recorded when it changes
+#endif
 	};
 }
\ No newline at end of file
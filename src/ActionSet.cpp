@@ -1,126 +1,962 @@
 #include "ActionSet.h"
 #include "Action.h"
+#include "TraceRecorder.h"
+#include "search/CatalogueFile.h"
+#include "search/QueryParser.h"
+#include "search/SearchBudget.h"
+#include "search/TopK.h"
+#include "search/Utf8.h"
+#include "search/VariantResults.h"
 
 #include <algorithm>
+#include <cassert>
 #include <cstdlib>
 #include <functional>
+#include <limits>
 #include <memory>
-#include <sstream>
 #include <string>
 
 namespace hotline {
     template<typename T, typename VariantType>
-    ActionSetBase<T, VariantType>::ActionSetBase() : _scorer(std::make_unique<FuzzyScorer>()) {}
+    ActionSetBase<T, VariantType>::ActionSetBase(std::pmr::memory_resource *resource)
+            : _resource(resource), _frameResource(resource), _index(resource), _slotActions(resource),
+              _slotByName(resource), _slotRequirements(resource), _availability(resource), _filters(resource),
+              _slotFilterKeys(resource), _scorer(std::make_unique<FuzzyScorer>()) {}
+
+    template<typename T, typename VariantType>
+    void ActionSetBase<T, VariantType>::AddSource(std::shared_ptr<IActionSource> source) {
+        _sources.push_back(std::move(source));
+        _revision++;
+    }
+
+    template<typename T, typename VariantType>
+    void ActionSetBase<T, VariantType>::RemoveAction(const std::string &name) {
+        auto found = _slotByName.find(name);
+        if (found == _slotByName.end()) {
+            return;
+        }
+        const SearchIndex::Slot slot = found->second;
+        OnRemoveAction(_slotActions[slot]);
+        _slotActions[slot] = T();
+        _slotRequirements[slot] = {};
+        ClearSlotFilters(slot);
+        // key is the index name, released by Remove
+        _slotByName.erase(found);
+        _index.Remove(slot);
+        UpdateSlotAvailability(slot);
+    }
+
+    template<typename T, typename VariantType>
+    void ActionSetBase<T, VariantType>::Reserve(size_t count) {
+        _index.Reserve(count);
+        if (count > _index.FreeSlotCount()) {
+            const size_t capacity = _index.SlotCount() + count - _index.FreeSlotCount();
+            _slotActions.reserve(capacity);
+            _slotRequirements.reserve(capacity);
+            _slotFilterKeys.reserve(capacity);
+            _availability.reserve((capacity + 63) / 64);
+        }
+        _slotByName.reserve(_slotByName.size() + count);
+    }
+
+    template<typename T, typename VariantType>
+    size_t ActionSetBase<T, VariantType>::GetActionCount() const {
+        return _index.Size();
+    }
+
+    template<typename T, typename VariantType>
+    void ActionSetBase<T, VariantType>::UpdateIndexBuild() {
+        // search results may change, exact and acronym matches of built slots are found by lookups now
+        if (_index.AdoptDeferredBuild()) {
+            _revision++;
+        }
+    }
+
+    template<typename T, typename VariantType>
+    bool ActionSetBase<T, VariantType>::SaveCatalogue(const std::string &path) const {
+        std::vector<std::string_view> names;
+        names.reserve(_index.Size());
+        for (SearchIndex::Slot slot = 0; slot < _index.SlotCount(); slot++) {
+            if (_index.IsAlive(slot)) {
+                names.push_back(_index.GetName(slot));
+            }
+        }
+        return WriteCatalogue(path, names);
+    }
+
+    template<typename T, typename VariantType>
+    bool ActionSetBase<T, VariantType>::HasAction(const std::string &name) const {
+        return FindSlot(name) != SearchIndex::noSlot;
+    }
+
+    template<typename T, typename VariantType>
+    bool ActionSetBase<T, VariantType>::AddActionAlias(const std::string &actionName, const std::string &alias) {
+        auto found = _slotByName.find(actionName);
+        if (found == _slotByName.end() || !_index.AddAlias(found->second, alias)) {
+            return false;
+        }
+        _revision++;
+        return true;
+    }
+
+    template<typename T, typename VariantType>
+    void ActionSetBase<T, VariantType>::AddActionEntry(const std::string &name, T action, bool deferIndex) {
+        if (auto found = _slotByName.find(name); found != _slotByName.end()) {
+            OnRemoveAction(_slotActions[found->second]);
+            _slotActions[found->second] = std::move(action);
+            return;
+        }
+
+        const SearchIndex::Slot slot = deferIndex ? _index.AddDeferred(name) : _index.Add(name);
+        if (slot == _slotActions.size()) {
+            _slotActions.push_back(std::move(action));
+            _slotRequirements.emplace_back();
+            _slotFilterKeys.emplace_back();
+            if (slot / 64 >= _availability.size()) {
+                _availability.push_back(0);
+            }
+        } else {
+            _slotActions[slot] = std::move(action);
+            _slotRequirements[slot] = {};
+        }
+        _slotByName.emplace(_index.GetName(slot), slot);
+        UpdateSlotAvailability(slot);
+    }
+
+    template<typename T, typename VariantType>
+    void ActionSetBase<T, VariantType>::SetContextFlag(const std::string &flag, bool value) {
+        const uint64_t bit = GetFlagBit(flag);
+        const uint64_t flags = value ? (_contextFlags | bit) : (_contextFlags & ~bit);
+        if (flags != _contextFlags) {
+            _contextFlags = flags;
+            RecomputeAvailability();
+        }
+    }
+
+    template<typename T, typename VariantType>
+    bool ActionSetBase<T, VariantType>::GetContextFlag(const std::string &flag) const {
+        auto found = _flagBits.find(flag);
+        return found != _flagBits.end() && ((_contextFlags >> found->second) & 1);
+    }
+
+    template<typename T, typename VariantType>
+    void ActionSetBase<T, VariantType>::SetActionRequirements(const std::string &actionName,
+                                                             const std::vector<std::string> &requiredFlags,
+                                                             const std::vector<std::string> &forbiddenFlags) {
+        auto found = _slotByName.find(actionName);
+        if (found == _slotByName.end()) {
+            return;
+        }
+        Requirements requirements;
+        for (const auto &flag: requiredFlags) {
+            requirements.required |= GetFlagBit(flag);
+        }
+        for (const auto &flag: forbiddenFlags) {
+            requirements.forbidden |= GetFlagBit(flag);
+        }
+        _slotRequirements[found->second] = requirements;
+        UpdateSlotAvailability(found->second);
+    }
+
+    template<typename T, typename VariantType>
+    bool ActionSetBase<T, VariantType>::IsActionAvailable(const std::string &actionName) const {
+        const SearchIndex::Slot slot = FindSlot(actionName);
+        return slot != SearchIndex::noSlot && IsSlotAvailable(slot);
+    }
+
+    template<typename T, typename VariantType>
+    void ActionSetBase<T, VariantType>::SetActionCategory(const std::string &actionName, const std::string &category) {
+        auto found = _slotByName.find(actionName);
+        if (found == _slotByName.end()) {
+            return;
+        }
+        const SearchIndex::Slot slot = found->second;
+        auto &keys = _slotFilterKeys[slot];
+        auto previous = std::find_if(keys.begin(), keys.end(), [](const std::string &key) { return key[0] == '@'; });
+        if (previous != keys.end()) {
+            _filters.Set(*previous, slot, false);
+            keys.erase(previous);
+            _revision++;
+        }
+        SetSlotFilter(slot, FilterIndex::MakeCategoryKey(category));
+    }
+
+    template<typename T, typename VariantType>
+    void ActionSetBase<T, VariantType>::AddActionTag(const std::string &actionName, const std::string &tag) {
+        auto found = _slotByName.find(actionName);
+        if (found != _slotByName.end()) {
+            SetSlotFilter(found->second, FilterIndex::MakeTagKey(tag));
+        }
+    }
+
+    template<typename T, typename VariantType>
+    bool ActionSetBase<T, VariantType>::IsSlotFiltered(SearchIndex::Slot slot,
+                                                      const std::vector<std::string> &filters) const {
+        if (!IsSlotAvailable(slot)) {
+            return false;
+        }
+        const auto &keys = _slotFilterKeys[slot];
+        for (const auto &filter: filters) {
+            if (std::find(keys.begin(), keys.end(), filter) == keys.end()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template<typename T, typename VariantType>
+    bool ActionSetBase<T, VariantType>::FindFilterBitmaps(const std::vector<std::string> &filters,
+                                                         std::vector<const FilterIndex::Bitmap *> &bitmaps) const {
+        bitmaps.clear();
+        for (const auto &filter: filters) {
+            const auto *bitmap = _filters.Find(filter);
+            if (!bitmap) {
+                return false;
+            }
+            bitmaps.push_back(bitmap);
+        }
+        return true;
+    }
+
+    template<typename T, typename VariantType>
+    void ActionSetBase<T, VariantType>::SetSlotFilter(SearchIndex::Slot slot, const std::string &key) {
+        auto &keys = _slotFilterKeys[slot];
+        if (key.size() > 1 && std::find(keys.begin(), keys.end(), key) == keys.end()) {
+            keys.push_back(key);
+            _filters.Set(key, slot, true);
+            _revision++;
+        }
+    }
+
+    template<typename T, typename VariantType>
+    void ActionSetBase<T, VariantType>::ClearSlotFilters(SearchIndex::Slot slot) {
+        for (const auto &key: _slotFilterKeys[slot]) {
+            _filters.Set(key, slot, false);
+        }
+        _slotFilterKeys[slot].clear();
+        _revision++;
+    }
+
+    template<typename T, typename VariantType>
+    uint64_t ActionSetBase<T, VariantType>::GetFlagBit(const std::string &flag) {
+        auto found = _flagBits.find(flag);
+        if (found == _flagBits.end()) {
+            assert(_flagBits.size() < 64 && "too many context flags for one action set");
+            found = _flagBits.emplace(flag, static_cast<int>(_flagBits.size())).first;
+        }
+        return uint64_t(1) << found->second;
+    }
+
+    template<typename T, typename VariantType>
+    void ActionSetBase<T, VariantType>::UpdateSlotAvailability(SearchIndex::Slot slot) {
+        const Requirements &requirements = _slotRequirements[slot];
+        const bool available = _index.IsAlive(slot)
+                               && (_contextFlags & requirements.required) == requirements.required
+                               && (_contextFlags & requirements.forbidden) == 0;
+        const uint64_t bit = uint64_t(1) << (slot % 64);
+        if (available) {
+            _availability[slot / 64] |= bit;
+        } else {
+            _availability[slot / 64] &= ~bit;
+        }
+        _revision++;
+    }
+
+    template<typename T, typename VariantType>
+    void ActionSetBase<T, VariantType>::RecomputeAvailability() {
+        for (size_t word = 0; word < _availability.size(); word++) {
+            uint64_t bits = 0;
+            const size_t end = std::min<size_t>(64, _index.SlotCount() - word * 64);
+            for (size_t bit = 0; bit < end; bit++) {
+                const SearchIndex::Slot slot = static_cast<SearchIndex::Slot>(word * 64 + bit);
+                const Requirements &requirements = _slotRequirements[slot];
+                if (_index.IsAlive(slot)
+                    && (_contextFlags & requirements.required) == requirements.required
+                    && (_contextFlags & requirements.forbidden) == 0) {
+                    bits |= uint64_t(1) << bit;
+                }
+            }
+            _availability[word] = bits;
+        }
+        _revision++;
+    }
+
+    template<typename T, typename VariantType>
+    SearchIndex::Slot ActionSetBase<T, VariantType>::FindSlot(const std::string &nameOrAlias) const {
+        auto found = _slotByName.find(nameOrAlias);
+        if (found != _slotByName.end()) {
+            return found->second;
+        }
+        return _index.FindExact(SearchIndex::Normalize(nameOrAlias));
+    }
+
+    template<typename T, typename VariantType>
+    T *ActionSetBase<T, VariantType>::FindAction(const std::string &name) {
+        const SearchIndex::Slot slot = FindSlot(name);
+        return slot != SearchIndex::noSlot ? &_slotActions[slot] : nullptr;
+    }
+
+    template<typename T, typename VariantType>
+    T *ActionSetBase<T, VariantType>::FindAvailableAction(const std::string &name) {
+        const SearchIndex::Slot slot = FindSlot(name);
+        return slot != SearchIndex::noSlot && IsSlotAvailable(slot) ? &_slotActions[slot] : nullptr;
+    }
+
+    template<typename T, typename VariantType>
+    bool ActionSetBase<T, VariantType>::ExecuteSourceAction(const std::string &name,
+                                                           const std::vector<std::string> &args) {
+        for (auto &source: _sources) {
+            if (source->ExecuteAction(name, args)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    namespace {
+        // sum of query token scores, 0 if any token doesn't match. Each token is checked by its mask first,
+        // so most names are dropped at first token with characters they don't have
+        int ScoreQuery(IFuzzyScorer &scorer, const ParsedQuery &query, std::string_view name,
+                       std::string_view lowerName, uint64_t mask, bool isAscii, const uint64_t *wordStarts) {
+            const int nameSize = static_cast<int>(name.size());
+            int total = 0;
+            for (const auto &token: query.tokens) {
+                if (!FuzzyScorer::IsMaskCovered(token.mask, mask) || !FuzzyScorer::IsSubsequence(token.lower, lowerName)) {
+                    return 0;
+                }
+                const int score = scorer.GetScore(token.text, token.lower, static_cast<int>(token.text.size()),
+                                                  name, lowerName, nameSize, token.isAscii && isAscii, wordStarts);
+                if (score <= 0) {
+                    return 0;
+                }
+                total += score;
+            }
+            return total;
+        }
+
+        // appends positions of all tokens merged, tokens may share matched characters. Returns sum of token
+        // scores, 0 with nothing appended if any token doesn't match
+        int AppendQueryPositions(IFuzzyScorer &scorer, const ParsedQuery &query, std::string_view name,
+                                 std::string_view lowerName, bool isAscii, const uint64_t *wordStarts,
+                                 std::vector<int> &positions) {
+            const int nameSize = static_cast<int>(name.size());
+            const size_t first = positions.size();
+            int total = 0;
+            for (const auto &token: query.tokens) {
+                const int score = scorer.AppendFuzzyPositions(token.text, token.lower,
+                                                              static_cast<int>(token.text.size()), name, lowerName,
+                                                              nameSize, token.isAscii && isAscii, wordStarts,
+                                                              positions);
+                if (score <= 0) {
+                    positions.resize(first);
+                    return 0;
+                }
+                total += score;
+            }
+            if (!query.IsSingleToken()) {
+                std::sort(positions.begin() + first, positions.end());
+                positions.erase(std::unique(positions.begin() + first, positions.end()), positions.end());
+            }
+            return total;
+        }
+    }
 
     void ActionSetFunc::AddAction(const std::string &name, std::function<void()> func) {
-        _actions[name] = func;
+        AddActionEntry(name, std::move(func));
     }
 
     void ActionSetFunc::ExecuteAction(const std::string &actionName) {
-        if (auto found = _actions.find(actionName); found != _actions.end()) {
-            found->second();
+        HOTLINE_TRACE_SCOPE("action", "execute action");
+        if (HasAction(actionName)) {
+            if (auto action = FindAvailableAction(actionName)) {
+                (*action)();
+            }
+        } else {
+            ExecuteSourceAction(actionName, {});
         }
     }
 
-    std::vector<FuzzyScore> ActionSetFunc::FindVariants(const std::string &query) {
-        std::vector<FuzzyScore> result;
+    namespace {
+        // source candidates checked per budget check of stepped search
+        constexpr size_t sourceChunk = 256;
+
+        struct Candidate {
+            int score = 0;
+            int slot = -1;              // -1 for source candidates, named by sourceName
+            std::string sourceName;
+            MatchKind kind = MatchKind::Subsequence;
+            int typos = 0;
+        };
+
+        // lowerName without surrounding spaces equals normalized, see SearchIndex::Normalize
+        bool IsNormalizedName(std::string_view lowerName, std::string_view normalized) {
+            const size_t begin = lowerName.find_first_not_of(' ');
+            if (normalized.empty() || begin == std::string_view::npos) {
+                return false;
+            }
+            return lowerName.substr(begin, lowerName.find_last_not_of(' ') - begin + 1) == normalized;
+        }
+
+        struct CandidateIsBetter {
+            bool operator()(const Candidate &a, const Candidate &b) const {
+                if (a.kind != b.kind) {
+                    return a.kind < b.kind;
+                }
+                if (a.typos != b.typos) {
+                    return a.typos < b.typos;
+                }
+                if (a.score != b.score) {
+                    return a.score > b.score;
+                }
+                // on ties registered actions go first, in slot order
+                if ((a.slot < 0) != (b.slot < 0)) {
+                    return b.slot < 0;
+                }
+                return a.slot != b.slot ? a.slot < b.slot : a.sourceName < b.sourceName;
+            }
+        };
+    }
+
+    // search for best `limit` matches of index slots and sources, which may be spread over several steps.
+    // Candidates are ranked by kind and score only, match positions are computed for the winners.
+    // forEachSlot(filters, f, firstWord, endWord) and isSlotAvailable(slot, filters) visit and check
+    // available slots passing query filters
+    class VariantSearch {
+    public:
+        // candidates are collected in resource, frame arena for one-shot searches
+        explicit VariantSearch(std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+                : _topK(resource), _winners(resource) {}
+
+        // exact name or alias hit and acronym hits come from hash lookups, so they are found at start
+        // and shown by first step already
+        template<typename IsSlotAvailable>
+        void Start(const SearchIndex &index, IsSlotAvailable &&isSlotAvailable, IFuzzyScorer &scorer,
+                   int typoTolerance, const std::string &query, size_t limit, uint64_t revision) {
+            _query = query;
+            _limit = limit;
+            _revision = revision;
+            _nextWord = 0;
+            _nextSource = 0;
+            _sourcePosition = 0;
+            _scanned = 0;
+
+            ParseQuery(query, _parsed);
+            _topK.Reset(limit);
+            _done = _parsed.IsEmpty() || limit == 0;
+            // acronyms and typos are looked for with single word queries only
+            _singleToken.clear();
+            if (_parsed.IsSingleToken()) {
+                _singleToken = _parsed.tokens.front().lower;
+            }
+            _typoMatcher.SetQuery(_singleToken, typoTolerance);
+            _exactSlot = SearchIndex::noSlot;
+            _hasAcronyms = false;
+            if (_done) {
+                return;
+            }
+
+            _normalizedQuery.clear();
+            if (!_parsed.tokens.empty()) {
+                _normalizedQuery = SearchIndex::Normalize(_parsed.text);
+                _exactSlot = index.FindExact(_normalizedQuery);
+            }
+            if (_exactSlot != SearchIndex::noSlot && isSlotAvailable(_exactSlot, _parsed.filters)) {
+                _topK.Push({ScoreSlot(index, scorer, _exactSlot), static_cast<int>(_exactSlot), {}, MatchKind::Exact});
+            } else {
+                _exactSlot = SearchIndex::noSlot;
+            }
+
+            const std::pmr::vector<SearchIndex::Slot> *acronymSlots =
+                    _singleToken.empty() ? nullptr : index.FindAcronym(_singleToken);
+            if (acronymSlots) {
+                _hasAcronyms = true;
+                for (const SearchIndex::Slot slot: *acronymSlots) {
+                    if (slot != _exactSlot && isSlotAvailable(slot, _parsed.filters)) {
+                        _topK.Push({ScoreSlot(index, scorer, slot), static_cast<int>(slot), {}, MatchKind::Acronym});
+                    }
+                }
+            }
+        }
+
+        // scans slots a word of 64 at a time while budget lasts, then sources in chunks of sourceChunk
+        // candidates where they support EnumerateFrom. True when everything is scanned
+        template<typename ForEachSlot>
+        bool Step(const SearchIndex &index, ForEachSlot &&forEachSlot,
+                  std::vector<std::shared_ptr<IActionSource>> &sources, IFuzzyScorer &scorer, SearchBudget &budget) {
+            // scorer time: names are scored while scanned
+            HOTLINE_TRACE_SPAN(span, "search", "score candidates");
+            [[maybe_unused]] const size_t scannedBefore = _scanned;
+            size_t scanned = 0;
+            auto scanSlot = [&](SearchIndex::Slot slot) {
+                scanned++;
+                if (slot == _exactSlot || (_hasAcronyms && index.GetAcronym(slot) == _singleToken)) {
+                    return;
+                }
+                const auto view = index.GetView(slot, _slotScratch);
+                // filters alone list every action passing them
+                const int score = ScoreView(scorer, view);
+                if (score > 0 || _parsed.tokens.empty()) {
+                    // slots waiting for deferred build are not in exact lookup yet
+                    const bool isExact = !index.IsIndexed(slot) && IsNormalizedName(view.lowerName, _normalizedQuery);
+                    const MatchKind kind = isExact ? MatchKind::Exact : MatchKind::Subsequence;
+                    _topK.Push({score, static_cast<int>(slot), {}, kind});
+                    return;
+                }
+                PushTypoMatch(view.lowerName, view.mask, static_cast<int>(slot), {});
+            };
+
+            const size_t wordCount = (index.SlotCount() + 63) / 64;
+            // source actions have no categories or tags, no filtered query can match them
+            const size_t sourceCount = _parsed.filters.empty() ? sources.size() : 0;
+            while (!_done) {
+                if (_nextWord < wordCount) {
+                    const size_t endWord = budget.IsUnlimited() ? wordCount : _nextWord + 1;
+                    forEachSlot(_parsed.filters, scanSlot, _nextWord, endWord);
+                    _nextWord = endWord;
+                } else if (_nextSource < sourceCount) {
+                    const size_t maxCount = budget.IsUnlimited() ? IActionSource::npos : sourceChunk;
+                    _sourcePosition = ScanSource(*sources[_nextSource], _sourcePosition, maxCount, scorer, scanned);
+                    if (_sourcePosition == IActionSource::npos) {
+                        _nextSource++;
+                        _sourcePosition = 0;
+                    }
+                } else {
+                    _done = true;
+                }
+                budget.Spend(scanned);
+                _scanned += scanned;
+                scanned = 0;
+                if (budget.IsExhausted()) {
+                    break;
+                }
+            }
+            HOTLINE_TRACE_SPAN_ARG(span, "candidates", _scanned - scannedBefore);
+            return _done;
+        }
+
+        // best variants found so far, best first
+        void GetVariants(const SearchIndex &index, IFuzzyScorer &scorer, VariantResults &results) {
+            HOTLINE_TRACE_SPAN(span, "search", "score winners");
+            _topK.GetSorted(_winners);
+            HOTLINE_TRACE_SPAN_ARG(span, "winners", _winners.size());
+
+            results.Clear();
+            for (const auto &winner: _winners) {
+                const bool isSource = winner.slot < 0;
+                SearchIndex::SlotView view;
+                if (isSource) {
+                    ToLower(winner.sourceName, _lowerScratch);
+                    view = {winner.sourceName, _lowerScratch, 0, IsAscii(winner.sourceName), nullptr};
+                } else {
+                    view = index.GetView(static_cast<SearchIndex::Slot>(winner.slot), _slotScratch);
+                }
+                const std::string_view name = view.name;
+                const std::string_view lowerName = view.lowerName;
+
+                VariantHandle handle;
+                handle.kind = winner.kind;
+                handle.slot = isSource ? SearchIndex::noSlot : static_cast<SearchIndex::Slot>(winner.slot);
+                handle.generation = isSource ? 0 : index.GetGeneration(handle.slot);
+                std::vector<int> &positions = results.BeginHandle();
+                if (winner.kind == MatchKind::Typo) {
+                    const auto match = _typoMatcher.Find(lowerName);
+                    handle.typos = static_cast<uint8_t>(match.edits);
+                    _typoMatcher.GetPositions(lowerName, match, positions);
+                } else {
+                    handle.score = AppendQueryPositions(scorer, _parsed, name, lowerName, view.isAscii,
+                                                        view.wordStarts, positions);
+                }
+                results.AddHandle(handle, isSource ? name : std::string_view());
+            }
+        }
+
+        bool IsStartedFor(const std::string &query, size_t limit, uint64_t revision) const {
+            return _query == query && _limit == limit && _revision == revision;
+        }
+
+        // names and source actions scanned since Start
+        size_t GetScannedCount() const { return _scanned; }
+
+    private:
+        int ScoreSlot(const SearchIndex &index, IFuzzyScorer &scorer, SearchIndex::Slot slot) {
+            return ScoreView(scorer, index.GetView(slot, _slotScratch));
+        }
+
+        int ScoreView(IFuzzyScorer &scorer, const SearchIndex::SlotView &view) const {
+            return ScoreQuery(scorer, _parsed, view.name, view.lowerName, view.mask, view.isAscii, view.wordStarts);
+        }
+
+        // position to continue from, npos when source is done
+        size_t ScanSource(IActionSource &source, size_t from, size_t maxCount, IFuzzyScorer &scorer,
+                          size_t &scanned) {
+            const SourceQuery sourceQuery{_parsed.text, _parsed.lower, _parsed.mask};
+            auto sink = [&](std::string_view name, std::string_view lowerName, uint64_t mask) {
+                scanned++;
+                if (lowerName.empty()) {
+                    ToLower(name, _lowerScratch);
+                    lowerName = _lowerScratch;
+                    mask = FuzzyScorer::ComputeCharMask(lowerName);
+                }
+                // registered action of the same name is ranked first already, as exact hit
+                if (_exactSlot != SearchIndex::noSlot && IsNormalizedName(lowerName, _normalizedQuery)) {
+                    return;
+                }
+                if (FuzzyScorer::IsMaskCovered(_parsed.mask, mask)) {
+                    const int score = ScoreQuery(scorer, _parsed, name, lowerName, mask, IsAscii(name), nullptr);
+                    if (score > 0) {
+                        if (!_topK.IsFullWithBetterThan({score, -1, {}})) {
+                            _topK.Push({score, -1, std::string(name)});
+                        }
+                        return;
+                    }
+                }
+                PushTypoMatch(lowerName, mask, -1, name);
+            };
+            const size_t next = source.EnumerateFrom(sourceQuery, from, maxCount, sink);
+            // candidates skipped by mask inside source are spent from budget too
+            if (next != IActionSource::npos) {
+                scanned = std::max(scanned, next - from);
+            }
+            return next;
+        }
+
+        // typo match is tried for names without exact match only. Its score is the negated end of
+        // matched substring, so matches closer to the name start go first
+        void PushTypoMatch(std::string_view lowerName, uint64_t mask, int slot, std::string_view name) {
+            if (!_typoMatcher.IsEnabled() || !_typoMatcher.MayMatch(_parsed.mask, mask)) {
+                return;
+            }
+            if (_topK.IsFullWithBetterThan({0, slot, {}, MatchKind::Typo, 1})) {
+                return;
+            }
+            const auto match = _typoMatcher.Find(lowerName);
+            if (match.edits > 0) {
+                Candidate candidate{-match.end, slot, {}, MatchKind::Typo, match.edits};
+                if (!_topK.IsFullWithBetterThan(candidate)) {
+                    candidate.sourceName.assign(name);
+                    _topK.Push(candidate);
+                }
+            }
+        }
+
+        std::string _query;
+        size_t _limit = 0;
+        uint64_t _revision = 0;
+        bool _done = true;
+
+        ParsedQuery _parsed;
+        std::string _normalizedQuery;
+        std::string _singleToken;
+        TypoMatcher _typoMatcher;
+        SearchIndex::Slot _exactSlot = SearchIndex::noSlot;
+        bool _hasAcronyms = false;
+        TopK<Candidate, CandidateIsBetter, std::pmr::vector<Candidate>> _topK;
+
+        size_t _nextWord = 0;       // next word of availability bits to scan
+        size_t _nextSource = 0;     // sources are scanned after all slots
+        size_t _sourcePosition = 0; // in source _nextSource, see IActionSource::EnumerateFrom
+        size_t _scanned = 0;
+
+        std::pmr::vector<Candidate> _winners;
+        std::string _lowerScratch;
+        std::string _slotScratch;   // lowercase names of slots waiting for deferred build
+    };
+
+    namespace {
+        template<typename ForEachSlot, typename IsSlotAvailable>
+        void FindActionVariants(const SearchIndex &index, ForEachSlot &&forEachSlot, IsSlotAvailable &&isSlotAvailable,
+                                std::vector<std::shared_ptr<IActionSource>> &sources, IFuzzyScorer &scorer,
+                                int typoTolerance, const std::string &query, size_t limit,
+                                std::pmr::memory_resource *resource, VariantResults &results) {
+            HOTLINE_TRACE_SPAN(span, "search", "FindVariants");
+            VariantSearch search(resource);
+            search.Start(index, isSlotAvailable, scorer, typoTolerance, query, limit, 0);
+            SearchBudget unlimited;
+            search.Step(index, forEachSlot, sources, scorer, unlimited);
+            search.GetVariants(index, scorer, results);
+            HOTLINE_TRACE_SPAN_ARG(span, "candidates", search.GetScannedCount());
+        }
+
+        // continues search of the same query, limit and set revision, otherwise starts new one
+        template<typename ForEachSlot, typename IsSlotAvailable>
+        bool StepActionVariants(std::unique_ptr<VariantSearch> &search, uint64_t revision, const SearchIndex &index,
+                                ForEachSlot &&forEachSlot, IsSlotAvailable &&isSlotAvailable,
+                                std::vector<std::shared_ptr<IActionSource>> &sources, IFuzzyScorer &scorer,
+                                int typoTolerance, const std::string &query, size_t limit,
+                                std::pmr::memory_resource *resource, SearchBudget &budget, VariantResults &results) {
+            HOTLINE_TRACE_SPAN(span, "search", "FindVariantsStep");
+            if (!search) {
+                search = std::make_unique<VariantSearch>(resource);
+            }
+            if (!search->IsStartedFor(query, limit, revision)) {
+                search->Start(index, isSlotAvailable, scorer, typoTolerance, query, limit, revision);
+            }
+            const bool done = search->Step(index, forEachSlot, sources, scorer, budget);
+            search->GetVariants(index, scorer, results);
+            HOTLINE_TRACE_SPAN_ARG(span, "candidates", search->GetScannedCount());
+            return done;
+        }
+
+        const std::vector<std::string_view> noArguments;
+
+        const std::vector<std::string_view> &GetArguments(const std::unique_ptr<BaseAction> &action) {
+            return action->GetArguments();
+        }
+
+        const std::vector<std::string_view> &GetArguments(const std::function<void()> &) {
+            return noArguments;
+        }
 
-        if (query.empty()) {
-            return result;
+        template<typename ActionSlots>
+        const std::vector<std::string_view> &GetActionArguments(const SearchIndex &index,
+                                                                const ActionSlots &actions,
+                                                                const VariantHandle &handle) {
+            // source actions take raw string arguments, so there are no argument names to show.
+            // Action may be removed since search, and its slot reused by another one
+            if (handle.IsSource() || !index.IsCurrent(handle.slot, handle.generation)) {
+                return noArguments;
+            }
+            return GetArguments(actions[handle.slot]);
         }
 
-        for (auto &action: _actions) {
-            auto lowerAction = action.first;
-            std::transform(lowerAction.begin(), lowerAction.end(), lowerAction.begin(), ::tolower);
+        template<typename ActionSlots>
+        void ResolveVariant(const SearchIndex &index, const ActionSlots &actions,
+                            const VariantHandle &handle, const VariantResults &results, ActionVariant &variant) {
+            variant.score = handle.score;
+            variant.kind = handle.kind;
+            variant.typos = handle.typos;
+            const int *positions = results.GetPositions(handle);
+            variant.positions.assign(positions, positions + handle.positionCount);
+            variant.actionName.assign(results.GetName(handle, index));
+            const auto &arguments = GetActionArguments(index, actions, handle);
+            variant.actionArguments.assign(arguments.begin(), arguments.end());
+            variant.scope = handle.scope;
+        }
 
-            auto lowerQuery = query;
-            std::transform(lowerQuery.begin(), lowerQuery.end(), lowerQuery.begin(), ::tolower);
+        template<typename ActionSlots>
+        std::vector<ActionVariant> ResolveVariants(const SearchIndex &index,
+                                                   const ActionSlots &actions,
+                                                   const VariantResults &results) {
+            std::vector<ActionVariant> variants(results.Size());
+            for (size_t i = 0; i < results.Size(); i++) {
+                ResolveVariant(index, actions, results[i], results, variants[i]);
+            }
+            return variants;
+        }
 
-            auto score = _scorer->GetFuzzyScore(query, lowerQuery, query.size(), action.first, lowerAction,
-                                                action.first.size());
-            if (score.score > 0) {
-                result.push_back(score);
+        // words separated by spaces or tabs, first one is action name. Arguments with spaces are quoted,
+        // "..." supports \" and \\ escapes, '...' is taken as is. Unterminated quote runs to the end
+        void SplitActionString(const std::string &actionString, std::string &actionName,
+                               std::vector<std::string> &args) {
+            //todo several actions with ; symbol?
+            std::string word;
+            bool first = true;
+            size_t i = 0;
+            const size_t size = actionString.size();
+            while (i < size) {
+                if (actionString[i] == ' ' || actionString[i] == '\t') {
+                    i++;
+                    continue;
+                }
+                word.clear();
+                while (i < size && actionString[i] != ' ' && actionString[i] != '\t') {
+                    const char c = actionString[i++];
+                    if (c != '"' && c != '\'') {
+                        word.push_back(c);
+                        continue;
+                    }
+                    for (; i < size && actionString[i] != c; i++) {
+                        if (c == '"' && actionString[i] == '\\' && i + 1 < size
+                            && (actionString[i + 1] == '"' || actionString[i + 1] == '\\')) {
+                            i++;
+                        }
+                        word.push_back(actionString[i]);
+                    }
+                    i++;    // closing quote
+                }
+                if (first) {
+                    actionName = word;
+                    first = false;
+                } else {
+                    args.push_back(word);
+                }
             }
         }
+    }
 
-        std::sort(result.begin(), result.end(),
-                    [](FuzzyScore &a, FuzzyScore &b) { return a.score > b.score; });
+    template<typename T, typename VariantType>
+    ActionSetBase<T, VariantType>::~ActionSetBase() = default;
 
-        return std::move(result);
+    template<typename T, typename VariantType>
+    std::vector<VariantType> ActionSetBase<T, VariantType>::FindVariants(const std::string &query) {
+        return FindVariants(query, std::numeric_limits<size_t>::max());
     }
-    // ActionSetBase::ActionSetBase()
-    //         : _scorer(std::make_unique<FuzzyScorer>()) {}
 
-    // void ActionSet::ExecuteAction(const std::string &name, const std::vector<std::string> &args) {
-    //     if (auto found = _actions.find(name); found != _actions.end()) {
-    //         ActionStartResult result = found->second->Start(args);
-    //         if (result == ActionStartResult::Failure) {
-    //             _state = InProgress;
-    //             _currentActionToFill = found->second.get();
-    //         } else {
-	// 			_state = Provided;
-    //         }
-    //     }
-    // }
+    template<typename T, typename VariantType>
+    std::vector<VariantType> ActionSetBase<T, VariantType>::FindVariants(const std::string &query, size_t limit) {
+        VariantResults results;
+        FindVariants(query, limit, results);
+        return ResolveVariants(_index, _slotActions, results);
+    }
 
-    // void ActionSet::Update() {
-    //     if (_state == InProgress) {
-	// 		_state = _currentActionToFill->UpdateProviding();
-    //     }
-    // }
+    template<typename T, typename VariantType>
+    void ActionSetBase<T, VariantType>::FindVariants(const std::string &query, size_t limit, VariantResults &results) {
+        UpdateIndexBuild();
+        FindActionVariants(_index, MakeForEachSlot(), MakeIsSlotAvailable(), _sources, *_scorer, _typoTolerance,
+                           query, limit, _frameResource, results);
+    }
 
-	// void ActionSet::Reset() {
-    //     _currentActionToFill = nullptr;
-    //     _state = None;
-	// }
+    template<typename T, typename VariantType>
+    bool ActionSetBase<T, VariantType>::FindVariantsStep(const std::string &query, size_t limit, SearchBudget &budget,
+                                                        VariantResults &results) {
+        UpdateIndexBuild();
+        return StepActionVariants(_search, _revision, _index, MakeForEachSlot(), MakeIsSlotAvailable(), _sources,
+                                  *_scorer, _typoTolerance, query, limit, _resource, budget, results);
+    }
 
-	// ArgumentProvidingState ActionSet::GetState() {
-    //     return _state;
-	// }
+    template<typename T, typename VariantType>
+    const std::vector<std::string_view> &
+    ActionSetBase<T, VariantType>::GetVariantArguments(const VariantHandle &handle) const {
+        return GetActionArguments(_index, _slotActions, handle);
+    }
 
-    // std::vector<ActionVariant> ActionSet::FindVariants(const std::string &query) {
-    //     std::vector<ActionVariant> result;
+    template<typename T, typename VariantType>
+    void ActionSetBase<T, VariantType>::ResolveVariant(const VariantHandle &handle, const VariantResults &results,
+                                                       VariantType &variant) const {
+        hotline::ResolveVariant(_index, _slotActions, handle, results, variant);
+    }
 
-    //     if (query.empty()) {
-    //         // for (auto &action: _actions) {
-    //         //     result.push_back({action.first, action.second->GetArguments(), {0, {}}});
-    //         // }
-    //         // return std::move(result);
-    //         return result;
-    //     }
+    template<typename T, typename VariantType>
+    bool ActionSetBase<T, VariantType>::FindExactVariant(const std::string &nameOrAlias, VariantType &variant) {
+        const SearchIndex::Slot slot = FindSlot(nameOrAlias);
+        if (slot == SearchIndex::noSlot || !IsSlotAvailable(slot)) {
+            return false;
+        }
+        variant = {};
+        variant.kind = MatchKind::Exact;
+        variant.actionName.assign(_index.GetName(slot));
+        const auto &arguments = GetArguments(_slotActions[slot]);
+        variant.actionArguments.assign(arguments.begin(), arguments.end());
+        return true;
+    }
 
-    //     for (auto &action: _actions) {
-    //         auto lowerAction = action.first;
-    //         std::transform(lowerAction.begin(), lowerAction.end(), lowerAction.begin(), ::tolower);
+    void ActionSetParBase::ExecuteAction(const std::string &actionString) {
+        std::string actionName;
+        std::vector<std::string> parsedArgs;
+        SplitActionString(actionString, actionName, parsedArgs);
+        ExecuteAction(actionName, parsedArgs);
+    }
 
-    //         auto lowerQuery = query;
-    //         std::transform(lowerQuery.begin(), lowerQuery.end(), lowerQuery.begin(), ::tolower);
+    void ActionSetFuncPar::ExecuteAction(const std::string &name, const std::vector<std::string> &args) {
+        if (HasAction(name)) {
+            if (auto action = FindAvailableAction(name)) {
+                HOTLINE_TRACE_SCOPE("action", TraceRecorder::Get().Intern((*action)->GetName()));
+                (*action)->Start(args);
+            }
+        } else {
+            HOTLINE_TRACE_SCOPE("action", "execute source action");
+            ExecuteSourceAction(name, args);
+        }
+    }
 
-    //         auto score = _scorer->GetFuzzyScore(query, lowerQuery, query.size(), action.first, lowerAction,
-    //                                             action.first.size());
-    //         if (score.score > 0) {
-    //             result.push_back({score, action.first, action.second->GetArguments()});
-    //         }
-    //     }
+    void ActionSetFuncParProvider::ExecuteAction(const std::string &name, const std::vector<std::string> &args) {
+        if (HasAction(name)) {
+            auto action = FindAvailableAction(name);
+            if (!action) {
+                return;
+            }
+            HOTLINE_TRACE_SPAN(span, "action", TraceRecorder::Get().Intern((*action)->GetName()));
+            ActionStartResult result = (*action)->Start(args);
+            HOTLINE_TRACE_SPAN_ARG(span, "result", result);
+            if (result == ActionStartResult::InvalidArguments) {
+                return;
+            }
+            if (result == ActionStartResult::Failure) {
+                _state = InProgress;
+                _currentActionToFill = action->get();
+            } else {
+                _state = Provided;
+                // by action name, name may be an alias
+                const std::string actionName((*action)->GetName());
+                const size_t argCount = (*action)->GetArguments().size();
+                if (args.size() > argCount) {
+                    _argumentHistory.Record(actionName, {args.begin(), args.begin() + argCount});
+                } else {
+                    _argumentHistory.Record(actionName, args);
+                }
+            }
+        } else {
+            HOTLINE_TRACE_SCOPE("action", "execute source action");
+            if (ExecuteSourceAction(name, args)) {
+                _state = Provided;
+            }
+        }
+    }
 
-    //     std::sort(result.begin(), result.end(),
-    //               [](ActionVariant &a, ActionVariant &b) { return a.score > b.score; });
+    CommandStatus ActionSetFuncParProvider::ExecuteCommand(const std::string &actionString) {
+        if (_state == InProgress) {
+            return CommandStatus::Busy;
+        }
+        std::string actionName;
+        std::vector<std::string> parsedArgs;
+        SplitActionString(actionString, actionName, parsedArgs);
+        if (!HasAction(actionName)) {
+            return ExecuteSourceAction(actionName, parsedArgs) ? CommandStatus::Executed
+                                                               : CommandStatus::UnknownAction;
+        }
+        if (!FindAvailableAction(actionName)) {
+            return CommandStatus::Unavailable;
+        }
+        const ArgumentProvidingState previousState = _state;
+        _state = None;
+        ExecuteAction(actionName, parsedArgs);
+        const ArgumentProvidingState state = _state;
+        _state = previousState;
+        _currentActionToFill = nullptr;
+        if (state == Provided) {
+            return CommandStatus::Executed;
+        }
+        return state == InProgress ? CommandStatus::MissingArguments : CommandStatus::InvalidArguments;
+    }
 
-    //     return std::move(result);
-    // }
+    void ActionSetFuncParProvider::CompleteArgument(const std::string &actionName, size_t argIdx,
+                                                    const std::string &prefix, std::vector<std::string> &out,
+                                                    size_t limit) {
+        out.clear();
+        if (auto action = FindAction(actionName)) {
+            if (argIdx >= (*action)->GetArguments().size()) {
+                return;
+            }
+            _argumentHistory.Complete(std::string((*action)->GetName()), argIdx, prefix,
+                                      (*action)->GetArgumentValueIndex(argIdx), limit, out);
+        }
+    }
 
-    // void ActionSet::ExecuteAction(const std::string &actionString) {
-    //     //todo several actions with ; symbol?
-    //     std::istringstream iss(actionString);
-    //     std::string actionName;
-    //     std::getline(iss, actionName, ' ');
+    void ActionSetFuncParProvider::OnRemoveAction(std::unique_ptr<BaseAction> &action) {
+        if (action.get() == _currentActionToFill) {
+            _currentActionToFill = nullptr;
+            _state = Cancelled;
+        }
+    }
 
-    //     std::vector<std::string> parsedArgs;
-    //     std::string argument;
-    //     while (std::getline(iss, argument, ' ')) {
-    //         parsedArgs.push_back(argument);
-    //     }
+    void ActionSetFuncParProvider::Update() {
+        if (_state == InProgress) {
+            // provider frontend draw, and the action itself once arguments are provided
+            HOTLINE_TRACE_SPAN(span, "provider", TraceRecorder::Get().Intern(_currentActionToFill->GetName()));
+            _state = _currentActionToFill->UpdateProviding();
+            HOTLINE_TRACE_SPAN_ARG(span, "state", _state);
+        }
+    }
+
+    void ActionSetFuncParProvider::Reset() {
+        _currentActionToFill = nullptr;
+        _state = None;
+    }
+
+    ArgumentProvidingState ActionSetFuncParProvider::GetState() {
+        return _state;
+    }
 
-    //     ExecuteAction(actionName, parsedArgs);
-    // }
-}
\ No newline at end of file
+    template class ActionSetBase<std::function<void()>, ActionVariant>;
+    template class ActionSetBase<std::unique_ptr<BaseAction>, ActionVariant>;
+}
@@ -1,72 +1,349 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
 #include <functional>
+#include <iterator>
 #include <string>
-#include <map>
 #include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 #include "Action.h"
+#include "ActionSource.h"
+#include "search/ArgumentCompletion.h"
+#include "search/FilterIndex.h"
 #include "search/FuzzyScorer.h"
+#include "search/SearchBudget.h"
+#include "search/SearchIndex.h"
+#include "search/TypoMatcher.h"
+#include "search/VariantResults.h"
 
 namespace hotline {
+	class VariantSearch;
+
 	struct ActionVariant : public FuzzyScore{
 		std::string actionName;
 		std::vector<std::string> actionArguments;
+		size_t scope = 0;   // index of set in ActionSetGroup which found this variant
+	};
+
+	// result of ExecuteCommand, commands come from outside of palette (scripts, CommandServer)
+	enum class CommandStatus {
+		Executed,
+		UnknownAction,
+		Unavailable,        // context flags don't allow the action now
+		MissingArguments,   // not enough arguments, action didn't start
+		InvalidArguments,   // argument couldn't be parsed, action didn't start
+		Busy,               // another action waits for arguments in provider frontend
 	};
 
+	template<typename Range, typename = void>
+	struct HasSize : std::false_type {};
+
+	template<typename Range>
+	struct HasSize<Range, std::void_t<decltype(std::size(std::declval<Range&>()))>> : std::true_type {};
+
 	template<typename T, typename VariantType>
 	class ActionSetBase {
 	public:
-		ActionSetBase();
+		// index and per-action storage are allocated from resource, it must outlive the set
+		explicit ActionSetBase(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+		virtual ~ActionSetBase();
+
+		// all matches, best first
+		std::vector<VariantType> FindVariants(const std::string& query);
+		std::vector<VariantType> FindVariants(const std::string& query, size_t limit);  // best `limit` only
+		// best `limit` as handles, strings are resolved by GetVariantName/GetVariantArguments when needed
+		void FindVariants(const std::string& query, size_t limit, VariantResults& results);
+		// FindVariants spread over calls, for frames which can't afford scanning whole set. Each call scans
+		// within budget and puts best variants found so far to results; true when search is complete.
+		// Search restarts when query, limit or set contents change
+		bool FindVariantsStep(const std::string& query, size_t limit, SearchBudget& budget, VariantResults& results);
+		// argument labels of result, empty for sources and actions removed since search
+		const std::vector<std::string_view>& GetVariantArguments(const VariantHandle& handle) const;
+		void ResolveVariant(const VariantHandle& handle, const VariantResults& results, VariantType& variant) const;
+		// exact name or alias hit without fuzzy scan, false if there is no such available action
+		bool FindExactVariant(const std::string& nameOrAlias, VariantType& variant);
+
+		// sources are queried on every search, registering one costs nothing until then
+		void AddSource(std::shared_ptr<IActionSource> source);
+
+		// range of std::pair<std::string, T>, actions are moved out of it. Capacity is reserved once
+		// for sized ranges, search index is updated per entry without rebuild, or in background (see
+		// SetBackgroundIndexing)
+		template<typename Range>
+		void AddActions(Range&& actions) {
+			if constexpr (HasSize<std::remove_reference_t<Range>>::value) {
+				Reserve(std::size(actions));
+			}
+			for (auto& entry : actions) {
+				AddActionEntry(entry.first, std::move(entry.second), _backgroundIndexing);
+			}
+			if (_backgroundIndexing) {
+				_index.StartDeferredBuild();
+			}
+		}
+
+		// AddActions only stores names and leaves search data to a background thread, so startup doesn't
+		// depend on catalogue size. Meanwhile new actions are found by plain scan of their names, without
+		// acronym matches; searches switch to index when they see the build finished (UpdateIndexBuild)
+		void SetBackgroundIndexing(bool enabled) { _backgroundIndexing = enabled; }
+		bool IsIndexReady() const { return _index.IsIndexReady(); }
+		float GetIndexProgress() const { return _index.GetBuildProgress(); }
+		// takes over finished background build, called by searches and by ActionManager::Update every frame
+		void UpdateIndexBuild();
+
+		// range of names, unknown ones are skipped. Freed slots are reused by next additions
+		template<typename Range>
+		void RemoveActions(const Range& names) {
+			for (const auto& name : names) {
+				RemoveAction(name);
+			}
+		}
+
+		void RemoveAction(const std::string& name);
+		void Reserve(size_t count);
+		size_t GetActionCount() const;
+		// names of all actions in catalogue file, for MappedCatalogueSource on next launches
+		bool SaveCatalogue(const std::string& path) const;
+		// names are also matched case-insensitively and by aliases, see AddActionAlias
+		bool HasAction(const std::string& name) const;
+
+		// alias is found and executed like the action name, typed exactly it is ranked first without
+		// fuzzy scoring. False if action is unknown or alias is taken by another action
+		bool AddActionAlias(const std::string& actionName, const std::string& alias);
+
+		// context flags (selection present, document open...) are named bits, up to 64 per set.
+		// Availability of all actions is recomputed only when a flag value changes
+		void SetContextFlag(const std::string& flag, bool value);
+		bool GetContextFlag(const std::string& flag) const;
 
-		virtual std::vector<VariantType> FindVariants(const std::string& query) = 0;
+		// action is available while all required flags are set and none of forbidden ones
+		void SetActionRequirements(const std::string& actionName, const std::vector<std::string>& requiredFlags,
+								   const std::vector<std::string>& forbiddenFlags = {});
+		bool IsActionAvailable(const std::string& actionName) const;
+
+		// metadata for query filters: "@category" and "#tag" words of query keep only actions having them.
+		// One category per action, setting another replaces it
+		void SetActionCategory(const std::string& actionName, const std::string& category);
+		void AddActionTag(const std::string& actionName, const std::string& tag);
+
+		// names which don't contain query as subsequence still match with up to maxEdits typos,
+		// ranked below all exact matches. 0 disables
+		void SetTypoTolerance(int maxEdits) { _typoTolerance = maxEdits; _revision++; }
+		int GetTypoTolerance() const { return _typoTolerance; }
+
+		// changes with anything search results depend on: actions, flags, metadata, typo tolerance, scorer
+		uint64_t GetRevision() const { return _revision; }
+
+		// name of search result, resolved from the index for actions of this set
+		std::string_view GetVariantName(const VariantHandle& handle, const VariantResults& results) const {
+			return results.GetName(handle, _index);
+		}
+
+		// ranking weights, e.g. std::make_unique<BasicFuzzyScorer<OwnPolicy>>() (see FuzzyScorer.h)
+		void SetScorer(std::unique_ptr<IFuzzyScorer> scorer) { _scorer = std::move(scorer); _revision++; }
+
+		// candidate and winner buffers of one-shot searches, released by owner between searches (see FrameArena).
+		// Stepped searches outlive a frame and keep their state in set resource, reused by next query.
+		// VariantResults are owned by caller and keep their capacity. Null returns to set resource
+		void SetFrameResource(std::pmr::memory_resource* resource) {
+			_frameResource = resource ? resource : _resource;
+		}
+		std::pmr::memory_resource* GetFrameResource() const { return _frameResource; }
 
 	protected:
-		std::map<std::string, T> _actions;
-		std::unique_ptr<FuzzyScorer> _scorer;
+		void AddActionEntry(const std::string& name, T action, bool deferIndex = false);
+		SearchIndex::Slot FindSlot(const std::string& nameOrAlias) const;
+		T* FindAction(const std::string& name);
+		T* FindAvailableAction(const std::string& name);
+		bool ExecuteSourceAction(const std::string& name, const std::vector<std::string>& args);
+
+		// called before action is destroyed by RemoveAction
+		virtual void OnRemoveAction(T&) {}
+
+		// calls f(slot) for every available action, skipping 64 unavailable slots per bit test.
+		// Words of 64 slots in [firstWord, endWord) only, for searches spread over several steps
+		template<typename F>
+		void ForEachAvailableSlot(F&& f, size_t firstWord = 0, size_t endWord = SIZE_MAX) const {
+			endWord = std::min(endWord, _availability.size());
+			for (size_t word = firstWord; word < endWord; word++) {
+				uint64_t bits = _availability[word];
+				while (bits) {
+					const int bit = CountTrailingZeros(bits);
+					f(static_cast<SearchIndex::Slot>(word * 64 + bit));
+					bits &= bits - 1;
+				}
+			}
+		}
+
+		bool IsSlotAvailable(SearchIndex::Slot slot) const {
+			return (_availability[slot / 64] >> (slot % 64)) & 1;
+		}
+
+		// as ForEachAvailableSlot, over slots having all filters (ParsedQuery::filters). Filter bitmaps are
+		// intersected with availability per word, so slots outside of filters are never visited
+		template<typename F>
+		void ForEachFilteredSlot(const std::vector<std::string>& filters, F&& f, size_t firstWord = 0,
+								 size_t endWord = SIZE_MAX) const {
+			if (filters.empty()) {
+				ForEachAvailableSlot(f, firstWord, endWord);
+				return;
+			}
+			std::vector<const FilterIndex::Bitmap*> bitmaps;
+			if (!FindFilterBitmaps(filters, bitmaps)) {
+				return;
+			}
+			size_t words = std::min(endWord, _availability.size());
+			for (const auto* bitmap : bitmaps) {
+				words = std::min(words, bitmap->size());
+			}
+			for (size_t word = firstWord; word < words; word++) {
+				uint64_t bits = _availability[word];
+				for (const auto* bitmap : bitmaps) {
+					bits &= (*bitmap)[word];
+				}
+				while (bits) {
+					const int bit = CountTrailingZeros(bits);
+					f(static_cast<SearchIndex::Slot>(word * 64 + bit));
+					bits &= bits - 1;
+				}
+			}
+		}
+
+		bool IsSlotFiltered(SearchIndex::Slot slot, const std::vector<std::string>& filters) const;
+
+		// slot visitors for searches over this set, see VariantSearch in ActionSet.cpp
+		auto MakeForEachSlot() const {
+			return [this](const std::vector<std::string>& filters, auto&& f, size_t firstWord, size_t endWord) {
+				ForEachFilteredSlot(filters, f, firstWord, endWord);
+			};
+		}
+
+		auto MakeIsSlotAvailable() const {
+			return [this](SearchIndex::Slot slot, const std::vector<std::string>& filters) {
+				return IsSlotFiltered(slot, filters);
+			};
+		}
+		// false if some filter is unknown, nothing can pass it
+		bool FindFilterBitmaps(const std::vector<std::string>& filters,
+							   std::vector<const FilterIndex::Bitmap*>& bitmaps) const;
+		void SetSlotFilter(SearchIndex::Slot slot, const std::string& key);
+		void ClearSlotFilters(SearchIndex::Slot slot);
+
+		static int CountTrailingZeros(uint64_t bits) {
+#if defined(_MSC_VER)
+			unsigned long index;
+			_BitScanForward64(&index, bits);
+			return static_cast<int>(index);
+#else
+			return __builtin_ctzll(bits);
+#endif
+		}
+
+		uint64_t GetFlagBit(const std::string& flag);
+		void UpdateSlotAvailability(SearchIndex::Slot slot);
+		void RecomputeAvailability();
+
+		struct Requirements {
+			uint64_t required = 0;
+			uint64_t forbidden = 0;
+		};
+
+		std::pmr::memory_resource* _resource;       // storage below and state of stepped searches
+		std::pmr::memory_resource* _frameResource;  // see SetFrameResource
+		SearchIndex _index;                     // names and derived search data by slot
+		std::pmr::vector<T> _slotActions;       // by index slot, empty for free slots
+		std::pmr::unordered_map<std::string_view, SearchIndex::Slot> _slotByName;  // keys are interned index names
+		std::pmr::vector<Requirements> _slotRequirements;   // by index slot
+		std::pmr::vector<uint64_t> _availability;           // bit per index slot, free slots are never available
+		FilterIndex _filters;
+		std::pmr::vector<std::pmr::vector<std::string>> _slotFilterKeys;    // by index slot, to clear bits on removal
+		std::unordered_map<std::string, int> _flagBits;
+		uint64_t _contextFlags = 0;
+		int _typoTolerance = 0;
+		bool _backgroundIndexing = false;
+		uint64_t _revision = 0;     // changed with anything search results depend on, restarts stepped searches
+		std::vector<std::shared_ptr<IActionSource>> _sources;
+		std::unique_ptr<IFuzzyScorer> _scorer;
+		std::unique_ptr<VariantSearch> _search;     // state of FindVariantsStep
 	};
 
-	class ActionSetFunc : public ActionSetBase<std::function<void()>, FuzzyScore> {
+	class ActionSetFunc : public ActionSetBase<std::function<void()>, ActionVariant> {
 	public:
+		using ActionSetBase::ActionSetBase;
+
 		void AddAction(const std::string& name, std::function<void()> func);
 		void ExecuteAction(const std::string& actionName);
-
-		std::vector<FuzzyScore> FindVariants(const std::string &query) override;
 	};
 
-	class ActionSetFuncPar : public ActionSetBase<std::unique_ptr<BaseAction>, ActionVariant> {
+	// for AddActions of sets with argument actions
+	template <typename F, typename... Args>
+	std::unique_ptr<BaseAction> MakeAction(const std::string& name, F&& f, Args&&... args) {
+		return std::make_unique<Action<
+				std::decay_t<F>, std::remove_cv_t<std::remove_reference_t<Args>>...>>
+			(name, std::forward<F>(f), std::forward<Args>(args)...);
+	}
+
+	// sets of actions with arguments, see MakeAction
+	class ActionSetParBase : public ActionSetBase<std::unique_ptr<BaseAction>, ActionVariant> {
 	public:
+		using ActionSetBase::ActionSetBase;
+
 		template <typename F, typename... Args>
 		void AddAction(const std::string& name, F&& f, Args&&... args) {
-			_actions[name] = std::make_unique<Action<
-					std::decay_t<F>, std::remove_cv_t<std::remove_reference_t<Args>>...>>
-				(name, std::forward<F>(f), std::forward<Args>(args)...);
+			AddActionEntry(name, MakeAction(name, std::forward<F>(f), std::forward<Args>(args)...));
 		}
 
-		void ExecuteAction(const std::string& name, const std::vector<std::string>& args);
+		virtual void ExecuteAction(const std::string& name, const std::vector<std::string>& args) = 0;
+		// "name arg1 arg2", arguments with spaces are quoted
 		void ExecuteAction(const std::string& actionString);
-		std::vector<ActionVariant> FindVariants(const std::string &query) override;
 	};
 
-	class ActionSetFuncParProvider : public ActionSetBase<std::unique_ptr<BaseAction>, ActionVariant> {
+	class ActionSetFuncPar : public ActionSetParBase {
 	public:
-		template <typename F, typename... Args>
-		void AddAction(const std::string& name, F&& f, Args&&... args) {
-			_actions[name] = std::make_unique<Action<
-					std::decay_t<F>, std::remove_cv_t<std::remove_reference_t<Args>>...>>
-				(name, std::forward<F>(f), std::forward<Args>(args)...);
-		}
+		using ActionSetParBase::ActionSetParBase;
+		using ActionSetParBase::ExecuteAction;
 
-		void ExecuteAction(const std::string& name, const std::vector<std::string>& args);
-		void ExecuteAction(const std::string& actionString);
-		std::vector<ActionVariant> FindVariants(const std::string &query) override;
+		void ExecuteAction(const std::string& name, const std::vector<std::string>& args) override;
+	};
+
+	class ActionSetFuncParProvider : public ActionSetParBase {
+	public:
+		using ActionSetParBase::ActionSetParBase;
+		using ActionSetParBase::ExecuteAction;
+
+		void ExecuteAction(const std::string& name, const std::vector<std::string>& args) override;
+		// "name arg1 arg2" like ExecuteAction, but action is never left waiting for provider frontend and
+		// providing state seen by frontends stays as it was
+		CommandStatus ExecuteCommand(const std::string& actionString);
+
+		// completions for argument argIdx of action, from values used before and argument presets
+		void CompleteArgument(const std::string& actionName, size_t argIdx, const std::string& prefix,
+							  std::vector<std::string>& out, size_t limit = 8);
 
 		void Update(); // to IActionBackend
 		void Reset(); // to IActionBackend
 		ArgumentProvidingState GetState(); // to IActionBackend
 
+	protected:
+		void OnRemoveAction(std::unique_ptr<BaseAction>& action) override;
+
 	private:
 		BaseAction* _currentActionToFill = nullptr; // to IActionBackend
-		ArgumentProvidingState _state; // to IActionBackend
+		ArgumentProvidingState _state = None; // to IActionBackend
+		ArgumentCompletionIndex _argumentHistory;
+	};
+
+	// set used by frontends (see IActionFrontend.h)
+	class ActionSet : public ActionSetFuncParProvider {
+	public:
+		using ActionSetFuncParProvider::ActionSetFuncParProvider;
 	};
 }
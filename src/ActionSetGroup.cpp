@@ -0,0 +1,239 @@
+#include "ActionSetGroup.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace hotline {
+	size_t ActionSetGroup::AddActionSet(const std::string& name, std::shared_ptr<ActionSet> set, bool enabled) {
+		assert(FindScope(name) < 0);
+		if (_frameResource) {
+			set->SetFrameResource(_frameResource);
+		}
+		_scopes.push_back({name, std::move(set), enabled});
+		RebuildEnabledScopes();
+		return _scopes.size() - 1;
+	}
+
+	void ActionSetGroup::SetActionSetEnabled(const std::string& name, bool enabled) {
+		const int scope = FindScope(name);
+		assert(scope >= 0);
+		if (_scopes[scope].enabled != enabled) {
+			_scopes[scope].enabled = enabled;
+			RebuildEnabledScopes();
+		}
+	}
+
+	void ActionSetGroup::SetFrameResource(std::pmr::memory_resource* resource) {
+		_frameResource = resource;
+		for (auto& scope : _scopes) {
+			scope.set->SetFrameResource(resource);
+		}
+	}
+
+	void ActionSetGroup::UpdateIndexBuild() {
+		for (auto& scope : _scopes) {
+			scope.set->UpdateIndexBuild();
+		}
+	}
+
+	bool ActionSetGroup::IsIndexReady() const {
+		for (const auto& scope : _scopes) {
+			if (!scope.set->IsIndexReady()) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	float ActionSetGroup::GetIndexProgress() const {
+		float progress = 1.0f;
+		for (const auto& scope : _scopes) {
+			progress = std::min(progress, scope.set->GetIndexProgress());
+		}
+		return progress;
+	}
+
+	bool ActionSetGroup::IsActionSetEnabled(const std::string& name) const {
+		const int scope = FindScope(name);
+		return scope >= 0 && _scopes[scope].enabled;
+	}
+
+	std::shared_ptr<ActionSet> ActionSetGroup::GetActionSet(const std::string& name) const {
+		const int scope = FindScope(name);
+		return scope >= 0 ? _scopes[scope].set : nullptr;
+	}
+
+	std::vector<ActionVariant> ActionSetGroup::FindVariants(const std::string& query, size_t limit) {
+		VariantResults results;
+		FindVariants(query, limit, results);
+		std::vector<ActionVariant> variants(results.Size());
+		for (size_t i = 0; i < results.Size(); i++) {
+			ResolveVariant(results[i], results, variants[i]);
+		}
+		return variants;
+	}
+
+	void ActionSetGroup::FindVariants(const std::string& query, size_t limit, VariantResults& results) {
+		results.Clear();
+		if (_enabledScopes.size() == 1) {
+			_scopes[_enabledScopes.front()].set->FindVariants(query, limit, _scopeResults);
+			results.Append(_scopeResults, static_cast<uint32_t>(_enabledScopes.front()));
+			return;
+		}
+
+		// every set returns its own best `limit`, so global best `limit` are among them
+		for (const size_t scope : _enabledScopes) {
+			_scopes[scope].set->FindVariants(query, limit, _scopeResults);
+			results.Append(_scopeResults, static_cast<uint32_t>(scope));
+		}
+		// ties keep scope order
+		results.Sort();
+		results.Truncate(limit);
+	}
+
+	bool ActionSetGroup::FindVariantsStep(const std::string& query, size_t limit, SearchBudget& budget,
+										  VariantResults& results) {
+		if (_stepQuery != query || _stepLimit != limit || _stepSearches.size() != _enabledScopes.size()) {
+			_stepQuery = query;
+			_stepLimit = limit;
+			// searches are restarted in place, so their result buffers keep capacity for the next query
+			_stepSearches.resize(_enabledScopes.size());
+			for (ScopeSearch& search : _stepSearches) {
+				search.results.Clear();
+				search.done = false;
+			}
+		}
+
+		bool done = true;
+		results.Clear();
+		for (size_t i = 0; i < _enabledScopes.size(); i++) {
+			ScopeSearch& search = _stepSearches[i];
+			const auto& set = _scopes[_enabledScopes[i]].set;
+			if (search.scope != _enabledScopes[i] || search.revision != set->GetRevision()) {
+				search.scope = _enabledScopes[i];
+				search.revision = set->GetRevision();
+				search.results.Clear();
+				search.done = false;
+			}
+			if (!search.done) {
+				search.done = set->FindVariantsStep(query, limit, budget, search.results);
+				// set restarts its own search on revision change too, result belongs to revision seen here
+				search.revision = set->GetRevision();
+			}
+			done = done && search.done;
+			results.Append(search.results, static_cast<uint32_t>(_enabledScopes[i]));
+		}
+
+		results.Sort();
+		results.Truncate(limit);
+		return done;
+	}
+
+	std::string_view ActionSetGroup::GetVariantName(const VariantHandle& handle, const VariantResults& results) const {
+		return _scopes[handle.scope].set->GetVariantName(handle, results);
+	}
+
+	const std::vector<std::string_view>& ActionSetGroup::GetVariantArguments(const VariantHandle& handle) const {
+		return _scopes[handle.scope].set->GetVariantArguments(handle);
+	}
+
+	void ActionSetGroup::ResolveVariant(const VariantHandle& handle, const VariantResults& results,
+										ActionVariant& variant) const {
+		_scopes[handle.scope].set->ResolveVariant(handle, results, variant);
+	}
+
+	bool ActionSetGroup::FindExactVariant(const std::string& nameOrAlias, ActionVariant& variant) {
+		for (const size_t scope : _enabledScopes) {
+			if (_scopes[scope].set->FindExactVariant(nameOrAlias, variant)) {
+				variant.scope = scope;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void ActionSetGroup::ExecuteAction(size_t scope, const std::string& name, const std::vector<std::string>& args) {
+		if (scope >= _scopes.size()) return;
+
+		_activeScope = scope;
+		_scopes[scope].set->ExecuteAction(name, args);
+	}
+
+	void ActionSetGroup::ExecuteAction(const std::string& name, const std::vector<std::string>& args) {
+		for (const size_t scope : _enabledScopes) {
+			if (_scopes[scope].set->IsActionAvailable(name)) {
+				ExecuteAction(scope, name, args);
+				return;
+			}
+		}
+		// unknown names may still be provided by sources of first set
+		if (!_enabledScopes.empty()) {
+			ExecuteAction(_enabledScopes.front(), name, args);
+		}
+	}
+
+	CommandStatus ActionSetGroup::ExecuteCommand(const std::string& command) {
+		if (GetState() == InProgress) {
+			return CommandStatus::Busy;
+		}
+		CommandStatus status = CommandStatus::UnknownAction;
+		for (const size_t scope : _enabledScopes) {
+			const CommandStatus scopeStatus = _scopes[scope].set->ExecuteCommand(command);
+			if (scopeStatus != CommandStatus::UnknownAction && scopeStatus != CommandStatus::Unavailable) {
+				return scopeStatus;
+			}
+			// action unavailable here may be available in one of next sets
+			if (scopeStatus == CommandStatus::Unavailable) {
+				status = scopeStatus;
+			}
+		}
+		return status;
+	}
+
+	void ActionSetGroup::CompleteArgument(size_t scope, const std::string& actionName, size_t argIdx,
+										  const std::string& prefix, std::vector<std::string>& out, size_t limit) {
+		if (scope >= _scopes.size()) {
+			out.clear();
+			return;
+		}
+		_scopes[scope].set->CompleteArgument(actionName, argIdx, prefix, out, limit);
+	}
+
+	void ActionSetGroup::Update() {
+		if (_activeScope < _scopes.size()) {
+			_scopes[_activeScope].set->Update();
+		}
+	}
+
+	void ActionSetGroup::Reset() {
+		if (_activeScope < _scopes.size()) {
+			_scopes[_activeScope].set->Reset();
+		}
+	}
+
+	ArgumentProvidingState ActionSetGroup::GetState() const {
+		if (_activeScope < _scopes.size()) {
+			return _scopes[_activeScope].set->GetState();
+		}
+		return None;
+	}
+
+	void ActionSetGroup::RebuildEnabledScopes() {
+		_enabledScopes.clear();
+		_stepSearches.clear();
+		for (size_t scope = 0; scope < _scopes.size(); scope++) {
+			if (_scopes[scope].enabled) {
+				_enabledScopes.push_back(scope);
+			}
+		}
+	}
+
+	int ActionSetGroup::FindScope(const std::string& name) const {
+		for (size_t scope = 0; scope < _scopes.size(); scope++) {
+			if (_scopes[scope].name == name) {
+				return static_cast<int>(scope);
+			}
+		}
+		return -1;
+	}
+}
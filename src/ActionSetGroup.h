@@ -0,0 +1,86 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Action.h"
+#include "ActionSet.h"
+
+namespace hotline {
+	// named action sets (per tool/editor context) searched as one. Disabled sets are skipped entirely
+	class ActionSetGroup {
+	public:
+		// returns scope index stored in ActionVariant::scope of found variants
+		size_t AddActionSet(const std::string& name, std::shared_ptr<ActionSet> set, bool enabled = true);
+		void SetActionSetEnabled(const std::string& name, bool enabled);
+		bool IsActionSetEnabled(const std::string& name) const;
+		std::shared_ptr<ActionSet> GetActionSet(const std::string& name) const;
+
+		// scratch of one-shot searches of all sets, also of ones added later (see ActionSet::SetFrameResource).
+		// Merged results are kept in reused VariantResults, not in resource. Null returns sets to their own
+		// resources
+		void SetFrameResource(std::pmr::memory_resource* resource);
+		std::pmr::memory_resource* GetFrameResource() const { return _frameResource; }
+
+		// background index builds of all sets (see ActionSet::SetBackgroundIndexing), progress is the lowest one
+		void UpdateIndexBuild();
+		bool IsIndexReady() const;
+		float GetIndexProgress() const;
+
+		// best `limit` variants over all enabled sets, ranked together
+		std::vector<ActionVariant> FindVariants(const std::string& query, size_t limit);
+		void FindVariants(const std::string& query, size_t limit, VariantResults& results);
+		// FindVariants spread over calls within budget (see ActionSet::FindVariantsStep), every unfinished set
+		// advances on each call. True when all sets are searched
+		bool FindVariantsStep(const std::string& query, size_t limit, SearchBudget& budget, VariantResults& results);
+
+		// strings of results, resolved by set which found them
+		std::string_view GetVariantName(const VariantHandle& handle, const VariantResults& results) const;
+		const std::vector<std::string_view>& GetVariantArguments(const VariantHandle& handle) const;
+		void ResolveVariant(const VariantHandle& handle, const VariantResults& results, ActionVariant& variant) const;
+		// exact name or alias hit in first enabled set which has it, no fuzzy scan
+		bool FindExactVariant(const std::string& nameOrAlias, ActionVariant& variant);
+
+		void ExecuteAction(size_t scope, const std::string& name, const std::vector<std::string>& args);
+		// first enabled set where action is available
+		void ExecuteAction(const std::string& name, const std::vector<std::string>& args);
+		// "name arg1 arg2" in first enabled set where action is available, see ActionSet::ExecuteCommand
+		CommandStatus ExecuteCommand(const std::string& command);
+
+		void CompleteArgument(size_t scope, const std::string& actionName, size_t argIdx, const std::string& prefix,
+							  std::vector<std::string>& out, size_t limit);
+
+		// providing state of set which executed last action
+		void Update();
+		void Reset();
+		ArgumentProvidingState GetState() const;
+
+	private:
+		struct Scope {
+			std::string name;
+			std::shared_ptr<ActionSet> set;
+			bool enabled = true;
+		};
+
+		void RebuildEnabledScopes();
+		int FindScope(const std::string& name) const;
+
+		struct ScopeSearch {
+			VariantResults results;     // best so far
+			size_t scope = 0;
+			uint64_t revision = 0;      // of set when search started, a changed set is searched again
+			bool done = false;
+		};
+
+		std::vector<Scope> _scopes;
+		std::vector<size_t> _enabledScopes;
+		size_t _activeScope = 0;
+		// FindVariantsStep state, by index in _enabledScopes
+		std::string _stepQuery;
+		size_t _stepLimit = 0;
+		std::vector<ScopeSearch> _stepSearches;
+		VariantResults _scopeResults;   // scratch of FindVariants
+		std::pmr::memory_resource* _frameResource = nullptr;
+	};
+}
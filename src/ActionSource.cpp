@@ -0,0 +1,288 @@
+#include "ActionSource.h"
+
+#include <algorithm>
+
+#include "search/FuzzyScorer.h"
+#include "search/Utf8.h"
+
+namespace hotline {
+    CachedActionSource::CachedActionSource(Collector collector, Executor executor)
+            : _collector(std::move(collector)), _executor(std::move(executor)) {}
+
+    void CachedActionSource::Enumerate(const SourceQuery &query, const CandidateSink &sink) {
+        EnumerateFrom(query, 0, npos, sink);
+    }
+
+    size_t CachedActionSource::EnumerateFrom(const SourceQuery &query, size_t from, size_t maxCount,
+                                             const CandidateSink &sink) {
+        EnsureCollected();
+        const size_t size = _names.size();
+        const size_t end = maxCount < size - std::min(from, size) ? from + maxCount : size;
+        for (size_t i = from; i < end; i++) {
+            if (FuzzyScorer::IsMaskCovered(query.queryMask, _masks[i])) {
+                sink(_names[i], _lowerNames[i], _masks[i]);
+            }
+        }
+        return end < size ? end : npos;
+    }
+
+    bool CachedActionSource::ExecuteAction(const std::string &name, const std::vector<std::string> &args) {
+        EnsureCollected();
+        if (_nameLookup.find(name) == _nameLookup.end()) {
+            return false;
+        }
+        _executor(name, args);
+        return true;
+    }
+
+    void CachedActionSource::Invalidate() {
+        _collected = false;
+        _nameLookup.clear();
+        _names.clear();
+        _lowerNames.clear();
+        _masks.clear();
+    }
+
+    void CachedActionSource::EnsureCollected() {
+        if (_collected) {
+            return;
+        }
+
+        _collector(_names);
+        _lowerNames.resize(_names.size());
+        _masks.resize(_names.size());
+        _nameLookup.reserve(_names.size());
+        for (size_t i = 0; i < _names.size(); i++) {
+            ToLower(_names[i], _lowerNames[i]);
+            _masks[i] = FuzzyScorer::ComputeCharMask(_lowerNames[i]);
+            _nameLookup.insert(_names[i]);
+        }
+        _collected = true;
+    }
+
+    StreamingActionSource::StreamingActionSource(Generator generator, Executor executor)
+            : _generator(std::move(generator)), _executor(std::move(executor)) {}
+
+    void StreamingActionSource::Enumerate(const SourceQuery &query, const CandidateSink &sink) {
+        _generator(query, sink);
+    }
+
+    bool StreamingActionSource::ExecuteAction(const std::string &name, const std::vector<std::string> &args) {
+        return _executor(name, args);
+    }
+
+    bool ConcurrentActionSource::Version::Contains(std::string_view name) const {
+        for (const auto &segment: segments) {
+            if (segment->nameLookup.count(name)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    ConcurrentActionSource::ConcurrentActionSource(Executor executor)
+            : _executor(std::move(executor)), _current(new Version()) {}
+
+    ConcurrentActionSource::~ConcurrentActionSource() {
+        delete _current.load();
+    }
+
+    void ConcurrentActionSource::AddActions(const std::vector<std::string> &names) {
+        std::lock_guard<std::mutex> lock(_writeMutex);
+        const Version *current = _current.load();
+
+        // segment is complete before it is published
+        auto segment = std::make_shared<Segment>();
+        segment->names.reserve(names.size());
+        std::unordered_set<std::string_view> added;
+        for (const auto &name: names) {
+            if (!current->Contains(name) && added.insert(name).second) {
+                segment->names.push_back(name);
+            }
+        }
+        if (segment->names.empty()) {
+            return;
+        }
+        segment->lowerNames.resize(segment->names.size());
+        segment->masks.resize(segment->names.size());
+        segment->nameLookup.reserve(segment->names.size());
+        for (size_t i = 0; i < segment->names.size(); i++) {
+            ToLower(segment->names[i], segment->lowerNames[i]);
+            segment->masks[i] = FuzzyScorer::ComputeCharMask(segment->lowerNames[i]);
+            segment->nameLookup.insert(segment->names[i]);
+        }
+
+        auto version = std::make_unique<Version>();
+        version->segments = current->segments;
+        version->segments.push_back(std::move(segment));
+        version->size = current->size + version->segments.back()->names.size();
+        Publish(std::move(version));
+    }
+
+    void ConcurrentActionSource::RemoveActions(const std::vector<std::string> &names) {
+        std::lock_guard<std::mutex> lock(_writeMutex);
+        const Version *current = _current.load();
+        const std::unordered_set<std::string_view> removed(names.begin(), names.end());
+
+        auto version = std::make_unique<Version>();
+        bool changed = false;
+        for (const auto &segment: current->segments) {
+            const bool touched = std::any_of(segment->names.begin(), segment->names.end(),
+                                             [&](const std::string &name) { return removed.count(name) != 0; });
+            if (!touched) {
+                version->segments.push_back(segment);
+                version->size += segment->names.size();
+                continue;
+            }
+            // segments are immutable, affected one is copied without removed names
+            changed = true;
+            auto kept = std::make_shared<Segment>();
+            for (size_t i = 0; i < segment->names.size(); i++) {
+                if (!removed.count(segment->names[i])) {
+                    kept->names.push_back(segment->names[i]);
+                    kept->lowerNames.push_back(segment->lowerNames[i]);
+                    kept->masks.push_back(segment->masks[i]);
+                }
+            }
+            if (kept->names.empty()) {
+                continue;
+            }
+            kept->nameLookup.insert(kept->names.begin(), kept->names.end());
+            version->size += kept->names.size();
+            version->segments.push_back(std::move(kept));
+        }
+        if (changed) {
+            Publish(std::move(version));
+        }
+    }
+
+    uint64_t ConcurrentActionSource::GetVersion() const {
+        Version *version = Acquire();
+        const uint64_t number = version->number;
+        Release(version);
+        return number;
+    }
+
+    size_t ConcurrentActionSource::Size() const {
+        Version *version = Acquire();
+        const size_t size = version->size;
+        Release(version);
+        return size;
+    }
+
+    size_t ConcurrentActionSource::GetSegmentCount() const {
+        Version *version = Acquire();
+        const size_t count = version->segments.size();
+        Release(version);
+        return count;
+    }
+
+    void ConcurrentActionSource::Enumerate(const SourceQuery &query, const CandidateSink &sink) {
+        Version *version = Acquire();
+        for (const auto &segment: version->segments) {
+            for (size_t i = 0; i < segment->names.size(); i++) {
+                if (FuzzyScorer::IsMaskCovered(query.queryMask, segment->masks[i])) {
+                    sink(segment->names[i], segment->lowerNames[i], segment->masks[i]);
+                }
+            }
+        }
+        Release(version);
+    }
+
+    bool ConcurrentActionSource::ExecuteAction(const std::string &name, const std::vector<std::string> &args) {
+        Version *version = Acquire();
+        const bool found = version->Contains(name);
+        Release(version);
+        if (found) {
+            _executor(name, args);
+        }
+        return found;
+    }
+
+    ConcurrentActionSource::Version *ConcurrentActionSource::Acquire() const {
+        // writer frees retired version only if nobody is acquiring and nobody pinned it, checked in this
+        // order (see ReclaimRetired). Whoever starts acquiring later loads a newer version
+        _acquiring.fetch_add(1);
+        Version *version = _current.load();
+        version->readers.fetch_add(1);
+        _acquiring.fetch_sub(1);
+        return version;
+    }
+
+    std::shared_ptr<const ConcurrentActionSource::Segment> ConcurrentActionSource::Merge(const Segment &first,
+                                                                                        const Segment &second) {
+        auto merged = std::make_shared<Segment>();
+        const size_t size = first.names.size() + second.names.size();
+        merged->names.reserve(size);
+        merged->lowerNames.reserve(size);
+        merged->masks.reserve(size);
+        for (const Segment *segment: {&first, &second}) {
+            merged->names.insert(merged->names.end(), segment->names.begin(), segment->names.end());
+            merged->lowerNames.insert(merged->lowerNames.end(), segment->lowerNames.begin(),
+                                      segment->lowerNames.end());
+            merged->masks.insert(merged->masks.end(), segment->masks.begin(), segment->masks.end());
+        }
+        // views into names, which don't move anymore
+        merged->nameLookup.reserve(size);
+        merged->nameLookup.insert(merged->names.begin(), merged->names.end());
+        return merged;
+    }
+
+    void ConcurrentActionSource::Publish(std::unique_ptr<Version> version) {
+        // merging while newest segment is at least half of previous one keeps sizes growing geometrically
+        // towards older segments, every name is copied O(log n) times over all additions
+        auto &segments = version->segments;
+        while (segments.size() >= 2) {
+            const Segment &previous = *segments[segments.size() - 2];
+            if (2 * segments.back()->names.size() < previous.names.size()) {
+                break;
+            }
+            auto merged = Merge(previous, *segments.back());
+            segments.pop_back();
+            segments.back() = std::move(merged);
+        }
+        version->number = _current.load()->number + 1;
+        _retired.emplace_back(_current.exchange(version.release()));
+        ReclaimRetired();
+    }
+
+    void ConcurrentActionSource::ReclaimRetired() {
+        if (_acquiring.load() != 0) {
+            return;
+        }
+        _retired.erase(std::remove_if(_retired.begin(), _retired.end(),
+                                      [](const std::unique_ptr<Version> &version) {
+                                          return version->readers.load() == 0;
+                                      }), _retired.end());
+    }
+
+    MappedCatalogueSource::MappedCatalogueSource(const std::string &path, Executor executor)
+            : _executor(std::move(executor)) {
+        _catalogue.Open(path);
+    }
+
+    void MappedCatalogueSource::Enumerate(const SourceQuery &query, const CandidateSink &sink) {
+        EnumerateFrom(query, 0, npos, sink);
+    }
+
+    size_t MappedCatalogueSource::EnumerateFrom(const SourceQuery &query, size_t from, size_t maxCount,
+                                                const CandidateSink &sink) {
+        const size_t size = _catalogue.Size();
+        const size_t end = maxCount < size - std::min(from, size) ? from + maxCount : size;
+        for (size_t i = from; i < end; i++) {
+            // broken entries are skipped here, Open doesn't check them
+            if (FuzzyScorer::IsMaskCovered(query.queryMask, _catalogue.GetMask(i)) && _catalogue.IsValid(i)) {
+                sink(_catalogue.GetName(i), _catalogue.GetLowerName(i), _catalogue.GetMask(i));
+            }
+        }
+        return end < size ? end : npos;
+    }
+
+    bool MappedCatalogueSource::ExecuteAction(const std::string &name, const std::vector<std::string> &args) {
+        if (_catalogue.Find(name) == MappedCatalogue::npos) {
+            return false;
+        }
+        _executor(name, args);
+        return true;
+    }
+}
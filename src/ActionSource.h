@@ -0,0 +1,181 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#include "search/CatalogueFile.h"
+
+namespace hotline {
+    struct SourceQuery {
+        std::string_view query;
+        std::string_view queryLower;
+        uint64_t queryMask = 0;     // FuzzyScorer::ComputeCharMask of queryLower
+    };
+
+    // receives candidates from source: name, its lowercase form and char mask.
+    // lowerName may be empty (and mask 0) if source doesn't keep them, set derives them then
+    using CandidateSink = std::function<void(std::string_view name, std::string_view lowerName, uint64_t mask)>;
+
+    // provides actions on demand instead of registering them up front (directory walker, scene graph,
+    // database cursor...). Set scores streamed candidates and merges them with its own actions.
+    class IActionSource {
+    public:
+        static constexpr size_t npos = ~size_t(0);
+
+        virtual ~IActionSource() = default;
+
+        // stream candidates for query. Sources may skip candidates whose mask doesn't cover query mask
+        virtual void Enumerate(const SourceQuery &query, const CandidateSink &sink) = 0;
+
+        // resumable Enumerate for searches spread over frames (see SearchBudget): checks up to maxCount
+        // candidates from position `from` and returns position to continue from, npos once all were checked.
+        // Sources without stable positions stream everything at once
+        virtual size_t EnumerateFrom(const SourceQuery &query, size_t /*from*/, size_t /*maxCount*/,
+                                     const CandidateSink &sink) {
+            Enumerate(query, sink);
+            return npos;
+        }
+
+        // returns false if action isn't provided by this source
+        virtual bool ExecuteAction(const std::string &name, const std::vector<std::string> &args) = 0;
+
+        // drop cached candidates, they will be collected again on next query
+        virtual void Invalidate() {}
+    };
+
+    // collects names on first query and keeps them with derived search data until invalidated
+    class CachedActionSource : public IActionSource {
+    public:
+        using Collector = std::function<void(std::vector<std::string> &names)>;
+        using Executor = std::function<void(const std::string &name, const std::vector<std::string> &args)>;
+
+        CachedActionSource(Collector collector, Executor executor);
+
+        void Enumerate(const SourceQuery &query, const CandidateSink &sink) override;
+        size_t EnumerateFrom(const SourceQuery &query, size_t from, size_t maxCount,
+                             const CandidateSink &sink) override;
+        bool ExecuteAction(const std::string &name, const std::vector<std::string> &args) override;
+        void Invalidate() override;
+
+    private:
+        void EnsureCollected();
+
+        Collector _collector;
+        Executor _executor;
+        bool _collected = false;
+
+        std::vector<std::string> _names;
+        std::vector<std::string> _lowerNames;
+        std::vector<uint64_t> _masks;
+        std::unordered_set<std::string_view> _nameLookup;
+    };
+
+    // nothing is kept: generator streams candidates for every query, e.g. from a database cursor
+    class StreamingActionSource : public IActionSource {
+    public:
+        using Generator = std::function<void(const SourceQuery &query, const CandidateSink &sink)>;
+        using Executor = std::function<bool(const std::string &name, const std::vector<std::string> &args)>;
+
+        StreamingActionSource(Generator generator, Executor executor);
+
+        void Enumerate(const SourceQuery &query, const CandidateSink &sink) override;
+        bool ExecuteAction(const std::string &name, const std::vector<std::string> &args) override;
+
+    private:
+        Generator _generator;
+        Executor _executor;
+    };
+
+    // names registered from any thread (asset loaders...) while searches run. Every change publishes a new
+    // immutable version which shares unchanged segments with previous one. Search pins current version with
+    // atomic counters, never locks and never sees a half-built segment. Writers serialize on a mutex and free
+    // versions no search pins anymore. Newest segment is merged into previous one while they are of similar
+    // size, so a version has O(log n) segments however names were added.
+    // Only names are kept: arguments, context flags, filter keys and aliases can't be given here, all actions
+    // run through one executor and are searched by fuzzy name only. Actions which need them belong in an
+    // action set, which is not thread-safe and is changed from the UI thread only
+    class ConcurrentActionSource : public IActionSource {
+    public:
+        using Executor = std::function<void(const std::string &name, const std::vector<std::string> &args)>;
+
+        explicit ConcurrentActionSource(Executor executor);
+        ~ConcurrentActionSource() override;
+
+        ConcurrentActionSource(const ConcurrentActionSource &) = delete;
+        ConcurrentActionSource &operator=(const ConcurrentActionSource &) = delete;
+
+        // thread-safe. Added names become one segment, names already published are skipped
+        void AddActions(const std::vector<std::string> &names);
+        void RemoveActions(const std::vector<std::string> &names);
+
+        // count of published versions, names and segments in current one
+        uint64_t GetVersion() const;
+        size_t Size() const;
+        size_t GetSegmentCount() const;
+
+        void Enumerate(const SourceQuery &query, const CandidateSink &sink) override;
+        bool ExecuteAction(const std::string &name, const std::vector<std::string> &args) override;
+
+    private:
+        struct Segment {
+            std::vector<std::string> names;
+            std::vector<std::string> lowerNames;
+            std::vector<uint64_t> masks;
+            std::unordered_set<std::string_view> nameLookup;
+        };
+
+        struct Version {
+            std::vector<std::shared_ptr<const Segment>> segments;
+            size_t size = 0;
+            uint64_t number = 0;
+            std::atomic<int> readers{0};
+
+            bool Contains(std::string_view name) const;
+        };
+
+        // version stays alive until released, even if newer one is published meanwhile
+        Version *Acquire() const;
+        static void Release(Version *version) { version->readers.fetch_sub(1); }
+
+        static std::shared_ptr<const Segment> Merge(const Segment &first, const Segment &second);
+
+        // under _writeMutex
+        void Publish(std::unique_ptr<Version> version);
+        void ReclaimRetired();
+
+        Executor _executor;
+        std::atomic<Version *> _current;
+        mutable std::atomic<int> _acquiring{0};     // readers between loading _current and pinning it
+        std::mutex _writeMutex;
+        std::vector<std::unique_ptr<Version>> _retired;
+    };
+
+    // names of catalogue file (see ActionSet::SaveCatalogue) streamed from read-only mapping. Startup only
+    // checks fixed-size entries, name strings are loaded by OS on first search
+    class MappedCatalogueSource : public IActionSource {
+    public:
+        using Executor = std::function<void(const std::string &name, const std::vector<std::string> &args)>;
+
+        // source stays empty if file can't be opened, see IsOpen
+        MappedCatalogueSource(const std::string &path, Executor executor);
+
+        bool IsOpen() const { return _catalogue.IsOpen(); }
+        size_t Size() const { return _catalogue.Size(); }
+
+        void Enumerate(const SourceQuery &query, const CandidateSink &sink) override;
+        size_t EnumerateFrom(const SourceQuery &query, size_t from, size_t maxCount,
+                             const CandidateSink &sink) override;
+        bool ExecuteAction(const std::string &name, const std::vector<std::string> &args) override;
+
+    private:
+        MappedCatalogue _catalogue;
+        Executor _executor;
+    };
+}
@@ -1,11 +1,23 @@
 #pragma once
 
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
 #include <iostream>
+#include <numeric>
 #include <string>
 #include <utility>
 #include <type_traits>
 #include <imgui.h>
 
+#include "search/ArgumentCompletion.h"
+#include "search/FuzzyScorer.h"
+#include "search/TopK.h"
+#include "search/Utf8.h"
+
 struct ArgProviderConfig {
     float scaleFactor = 1.0f;
     float windowFontScale = 1.2f;
@@ -22,6 +34,7 @@ struct ArgProviderConfig {
     float customProviderButtonWidth = 0.4f;
     ImGuiKey customProviderButtonKey = ImGuiKey_Tab;
     ImGuiInputTextFlags inputTextFlags = ImGuiInputTextFlags_EscapeClearsAll;
+    size_t searchResultLimit = 1000;    // SearchArgProvider keeps only best results for non-empty filter
 
     ImGuiWindowFlags windowFlags = ImGuiWindowFlags_NoTitleBar
                                        | ImGuiWindowFlags_NoMove
@@ -39,8 +52,9 @@ struct ArgProviderBase {
     ArgumentProvidingState _state = InProgress;
     bool _canCaptureInput = false;
     char _inputBuffer[128] = "";
+    std::string _customChildId;
 
-    explicit ArgProviderBase(std::string name) : _name(std::move(name)) {}
+    explicit ArgProviderBase(std::string name) : _name(std::move(name)), _customChildId(_name + "_custom") {}
 
     virtual ~ArgProviderBase() = default;
 
@@ -54,7 +68,7 @@ struct ArgProviderBase {
         ImGui::BeginChild(_name.c_str(), {windowSize.x, windowSize.y * 0.7f}, true, argConfig.windowFlags);
         OnGuiProvide();
         ImGui::EndChild();
-        ImGui::BeginChild((_name + "_custom").c_str(), {windowSize.x, windowSize.y * 0.1f}, true, argConfig.windowFlags);
+        ImGui::BeginChild(_customChildId.c_str(), {windowSize.x, windowSize.y * 0.1f}, true, argConfig.windowFlags);
         OnCustomProvide();
         ImGui::EndChild();
 
@@ -117,7 +131,14 @@ struct ArgProviderBase {
     virtual void OnApply() = 0;         // _arg probably should be filled here
     virtual void OnReset() = 0;
 
-    virtual void ProvideFromString(const std::string &str) = 0;
+    // false if str is not valid value, _arg may be left unchanged then
+    virtual bool ProvideFromString(const std::string &str) = 0;
+
+    // string forms of values this provider offers by prefix, used for argument completion in hotline.
+    // Null if provider has no known values or doesn't have them yet
+    virtual const hotline::PrefixIndex *GetValueIndex() {
+        return nullptr;
+    }
 
     void Reset() {
         _state = InProgress;
@@ -133,6 +154,10 @@ struct ArgProviderBase {
 template<typename T>
 struct PresetArgProvider : public ArgProviderBase<T> {
     std::vector<std::vector<T>> _presets;
+    std::vector<std::vector<std::string>> _presetLabels;    // button labels with unique ids, see RefreshPresetLabels
+    std::vector<std::string> _presetStrings;                // plain labels, row by row
+    hotline::PrefixIndex _presetIndex;                      // _presetStrings for completion
+    bool _presetLabelsDirty = true;
     int _presetRow = 0;
     int _presetCol = 0;
 
@@ -143,7 +168,39 @@ struct PresetArgProvider : public ArgProviderBase<T> {
 
     virtual ~PresetArgProvider() = default;
 
+    // use this instead of assigning _presets directly, so cached labels are rebuilt
+    void SetPresets(std::vector<std::vector<T>> presets) {
+        _presets = std::move(presets);
+        _presetLabelsDirty = true;
+    }
+
+    // ToString is virtual, so labels can't be built in constructor and are built on first draw instead
+    void RefreshPresetLabels() {
+        _presetLabels.resize(_presets.size());
+        _presetStrings.clear();
+        for (size_t i = 0; i < _presets.size(); i++) {
+            _presetLabels[i].resize(_presets[i].size());
+            for (size_t j = 0; j < _presets[i].size(); j++) {
+                _presetStrings.push_back(ToString(_presets[i][j]));
+                _presetLabels[i][j] = _presetStrings.back() + "##" + std::to_string(i) + "_" + std::to_string(j);
+            }
+        }
+        _presetIndex.Build(_presetStrings);
+        _presetLabelsDirty = false;
+    }
+
+    const hotline::PrefixIndex *GetValueIndex() override {
+        if (_presetLabelsDirty) {
+            RefreshPresetLabels();
+        }
+        return &_presetIndex;
+    }
+
     void OnGuiProvide() override {
+        if (_presetLabelsDirty) {
+            RefreshPresetLabels();
+        }
+
         if(ImGui::IsKeyPressed(ImGuiKey_DownArrow) || ImGui::IsKeyPressed(ImGuiKey_UpArrow) ||ImGui::IsKeyPressed(ImGuiKey_RightArrow) || ImGui::IsKeyPressed(ImGuiKey_LeftArrow)){
             if(_presetCol == -1 && _presetRow == -1){
                 _presetCol = 0;
@@ -191,7 +248,7 @@ struct PresetArgProvider : public ArgProviderBase<T> {
                 ImGui::PushStyleColor(ImGuiCol_Button, color);
                 ImGui::PushStyleColor(ImGuiCol_ButtonActive, color);
                 ImGui::PushStyleColor(ImGuiCol_ButtonHovered, hoveredColor);
-                if (ImGui::Button(ToString(_presets[i][j]).c_str(), buttonSize)) {
+                if (ImGui::Button(_presetLabels[i][j].c_str(), buttonSize)) {
                     _presetCol = i;
                     _presetRow = j;
                 }
@@ -241,7 +298,10 @@ struct PresetArgProvider : public ArgProviderBase<T> {
         if(_presetRow >= 0 && _presetCol >= 0){
             this->_arg = _presets[_presetCol][_presetRow];
         }else{
-            ProvideFromString(this->_inputBuffer);
+            if (!ProvideFromString(this->_inputBuffer)) {
+                // input stays open until value parses
+                this->_state = InProgress;
+            }
         }
     }
 
@@ -253,7 +313,7 @@ struct PresetArgProvider : public ArgProviderBase<T> {
 
     virtual std::string ToString(const T &arg) = 0;
 
-    virtual void ProvideFromString(const std::string &str) override = 0;
+    virtual bool ProvideFromString(const std::string &str) override = 0;
 };
 
 template<typename T>
@@ -264,79 +324,336 @@ struct ArgProvider : public PresetArgProvider<T> {
 template<>
 struct ArgProvider<int> : public PresetArgProvider<int> {
     explicit ArgProvider(std::string name) : PresetArgProvider<int>(name) {
-        _presets = {{1, 100, 1000, 10000},
-						{-1, -100, -1000, -10000}};
+        SetPresets({{1, 100, 1000, 10000},
+					{-1, -100, -1000, -10000}});
     }
 
     ArgProvider(const std::string &name, std::vector<std::vector<int>> presetArgs) : PresetArgProvider<int>(name){
-	    _presets = presetArgs;
+	    SetPresets(std::move(presetArgs));
     }
 
     std::string ToString(const int &arg) override {
         return std::to_string(arg);
     }
 
-    void ProvideFromString(const std::string &str) override {
-        _arg = atoi(str.c_str());
+    bool ProvideFromString(const std::string &str) override {
+        char *end = nullptr;
+        errno = 0;
+        const long value = std::strtol(str.c_str(), &end, 10);
+        if (end == str.c_str() || *end != '\0' || errno == ERANGE || value < INT_MIN || value > INT_MAX) {
+            return false;
+        }
+        _arg = static_cast<int>(value);
+        return true;
     }
 };
 
 template<>
 struct ArgProvider<unsigned> : public PresetArgProvider<unsigned> {
     explicit ArgProvider(std::string name) : PresetArgProvider<unsigned>(name) {
-        _presets = {{1,  100, 1000, 10000},
-						{10, 500, 5000, 50000}};
+        SetPresets({{1,  100, 1000, 10000},
+					{10, 500, 5000, 50000}});
     }
 
     ArgProvider(const std::string &name, std::vector<std::vector<unsigned>> presetArgs) : PresetArgProvider<unsigned>(name){
-	    _presets = presetArgs;
+	    SetPresets(std::move(presetArgs));
     }
 
     std::string ToString(const unsigned &arg) override {
         return std::to_string(arg);
     }
 
-    void ProvideFromString(const std::string &str) override {
-        _arg = atoi(str.c_str());
+    bool ProvideFromString(const std::string &str) override {
+        // strtoul accepts negative numbers and wraps them
+        if (str.find('-') != std::string::npos) {
+            return false;
+        }
+        char *end = nullptr;
+        errno = 0;
+        const unsigned long value = std::strtoul(str.c_str(), &end, 10);
+        if (end == str.c_str() || *end != '\0' || errno == ERANGE || value > UINT_MAX) {
+            return false;
+        }
+        _arg = static_cast<unsigned>(value);
+        return true;
     }
 };
 
 template<>
 struct ArgProvider<std::string> : public PresetArgProvider<std::string> {
     explicit ArgProvider(std::string name) : PresetArgProvider<std::string>(name) {
-        _presets = {{"one",   "two",   "three"},
+        SetPresets({{"one",   "two",   "three"},
                     {"four",  "five",  "six"},
-                    {"seven", "eight", "nine"}};
+                    {"seven", "eight", "nine"}});
     }
 
     ArgProvider(const std::string &name, std::vector<std::vector<std::string>> presetArgs) : PresetArgProvider<std::string>(name){
-	    _presets = presetArgs;
+	    SetPresets(std::move(presetArgs));
     }
 
     std::string ToString(const std::string &arg) override {
         return arg;
     }
 
-    void ProvideFromString(const std::string &str) override {
+    bool ProvideFromString(const std::string &str) override {
         _arg = str;
+        return true;
     }
 };
 
 template<>
 struct ArgProvider<bool> : public PresetArgProvider<bool> {
     explicit ArgProvider(std::string name) : PresetArgProvider<bool>(name) {
-        _presets = {{true, false}};
+        SetPresets({{true, false}});
     }
 
     std::string ToString(const bool &arg) override {
         return arg ? "TRUE" : "FALSE";
     }
 
-    void ProvideFromString(const std::string &str) override {
-        if (str == "true" || str == "1") {
+    // ToString form is accepted too, so completed preset labels parse
+    bool ProvideFromString(const std::string &str) override {
+        if (str == "true" || str == "1" || str == "TRUE") {
             _arg = true;
+        } else if (str == "false" || str == "0" || str == "FALSE") {
+            _arg = false;
         } else {
-			_arg = false;
+            return false;
+        }
+        return true;
+    }
+};
+
+// for big value domains (asset names, entities): type-to-filter list, only visible rows are drawn
+template<typename T>
+struct SearchArgProvider : public ArgProviderBase<T> {
+    std::vector<T> _values;
+    std::function<std::vector<T>()> _generator;    // optional lazy source of _values, called on first draw
+    bool _valuesDirty = true;
+
+    // derived per value in RefreshValues
+    std::vector<std::string> _labels;
+    std::vector<std::string> _lowerLabels;
+    std::vector<uint64_t> _labelMasks;
+    std::vector<uint8_t> _labelAscii;                   // scorer compares bytes without decoding for ASCII labels
+    std::vector<std::vector<uint64_t>> _labelWordStarts; // see FuzzyScorer::ComputeWordStarts
+    hotline::PrefixIndex _labelIndex;           // _labels for completion, built on first completion after refresh
+    bool _labelIndexDirty = true;
+
+    std::string _filter;
+    std::string _filterLower;
+    bool _filterDirty = true;
+    std::vector<int> _candidates;               // values matching _filter as subsequence, narrowed while filter grows
+    std::vector<hotline::ScoredIndex> _visible; // rows to show, best first
+    hotline::ScoredIndexTopK _topK;
+    hotline::FuzzyScorer _scorer;
+
+    int _selected = 0;
+    bool _scrollToSelected = false;
+
+    SearchArgProvider(const std::string &name, std::vector<T> values) : ArgProviderBase<T>(name),
+                                                                        _values(std::move(values)) {}
+
+    SearchArgProvider(const std::string &name, std::function<std::vector<T>()> generator)
+            : ArgProviderBase<T>(name), _generator(std::move(generator)) {}
+
+    virtual ~SearchArgProvider() = default;
+
+    void SetValues(std::vector<T> values) {
+        _values = std::move(values);
+        _generator = nullptr;
+        _valuesDirty = true;
+    }
+
+    void SetGenerator(std::function<std::vector<T>()> generator) {
+        _generator = std::move(generator);
+        _valuesDirty = true;
+    }
+
+    // forces generator to run again on next draw
+    void Invalidate() {
+        _valuesDirty = true;
+    }
+
+    void RefreshValues() {
+        if (_generator) {
+            _values = _generator();
+        }
+        _labels.resize(_values.size());
+        _lowerLabels.resize(_values.size());
+        _labelMasks.resize(_values.size());
+        _labelAscii.resize(_values.size());
+        _labelWordStarts.resize(_values.size());
+        for (size_t i = 0; i < _values.size(); i++) {
+            _labels[i] = ToString(_values[i]);
+            hotline::ToLower(_labels[i], _lowerLabels[i]);
+            _labelMasks[i] = hotline::FuzzyScorer::ComputeCharMask(_lowerLabels[i]);
+            _labelAscii[i] = hotline::IsAscii(_labels[i]);
+            hotline::FuzzyScorer::ComputeWordStarts(_labels[i], _labelWordStarts[i]);
+        }
+        _valuesDirty = false;
+        _filterDirty = true;
+        _labelIndexDirty = true;
+    }
+
+    // generator isn't run for completion, its values are completed once the provider was drawn
+    const hotline::PrefixIndex *GetValueIndex() override {
+        if (_valuesDirty) {
+            if (_generator) {
+                return nullptr;
+            }
+            RefreshValues();
+        }
+        if (_labelIndexDirty) {
+            _labelIndex.Build(_labels);
+            _labelIndexDirty = false;
         }
+        return &_labelIndex;
     }
-};
\ No newline at end of file
+
+    void RefreshFilter() {
+        const bool narrowing = !_filterDirty && !_filter.empty()
+                               && std::strncmp(this->_inputBuffer, _filter.c_str(), _filter.size()) == 0;
+        _filter = this->_inputBuffer;
+        hotline::ToLower(_filter, _filterLower);
+        _filterDirty = false;
+        _selected = 0;
+        _scrollToSelected = true;
+
+        if (_filter.empty()) {
+            _candidates.resize(_values.size());
+            std::iota(_candidates.begin(), _candidates.end(), 0);
+            _visible.resize(_values.size());
+            for (size_t i = 0; i < _values.size(); i++) {
+                _visible[i] = {0, static_cast<int>(i)};
+            }
+            return;
+        }
+
+        if (!narrowing) {
+            _candidates.resize(_values.size());
+            std::iota(_candidates.begin(), _candidates.end(), 0);
+        }
+
+        // candidates are filtered in place: a longer filter can only match a subset of previous matches
+        const uint64_t filterMask = hotline::FuzzyScorer::ComputeCharMask(_filterLower);
+        const int filterSize = static_cast<int>(_filter.size());
+        const bool filterAscii = hotline::IsAscii(_filter);
+        size_t kept = 0;
+        _topK.Reset(argConfig.searchResultLimit);
+        for (const int idx: _candidates) {
+            if (!hotline::FuzzyScorer::IsMaskCovered(filterMask, _labelMasks[idx])
+                || !hotline::FuzzyScorer::IsSubsequence(_filterLower, _lowerLabels[idx])) {
+                continue;
+            }
+            _candidates[kept++] = idx;
+            const int score = _scorer.GetScore(_filter, _filterLower, filterSize, _labels[idx], _lowerLabels[idx],
+                                               static_cast<int>(_labels[idx].size()),
+                                               filterAscii && _labelAscii[idx], _labelWordStarts[idx].data());
+            _topK.Push({score, idx});
+        }
+        _candidates.resize(kept);
+        _topK.TakeSorted(_visible);
+    }
+
+    void OnGuiProvide() override {
+        if (_valuesDirty) {
+            RefreshValues();
+        }
+        if (_filterDirty || std::strcmp(this->_inputBuffer, _filter.c_str()) != 0) {
+            RefreshFilter();
+        }
+
+        const int visibleCount = static_cast<int>(_visible.size());
+        if (visibleCount > 0) {
+            if (ImGui::IsKeyPressed(ImGuiKey_DownArrow)) {
+                _selected = _selected + 1 >= visibleCount ? 0 : _selected + 1;
+                _scrollToSelected = true;
+            }
+            if (ImGui::IsKeyPressed(ImGuiKey_UpArrow)) {
+                _selected = _selected - 1 < 0 ? visibleCount - 1 : _selected - 1;
+                _scrollToSelected = true;
+            }
+        }
+
+        ImGui::BeginChild("##values", ImGui::GetContentRegionAvail(), false, ImGuiWindowFlags_NoNav);
+        const float rowHeight = ImGui::GetTextLineHeightWithSpacing();
+        if (_scrollToSelected) {
+            const float rowTop = _selected * rowHeight;
+            const float scrollY = ImGui::GetScrollY();
+            const float windowHeight = ImGui::GetWindowHeight();
+            if (rowTop < scrollY) {
+                ImGui::SetScrollY(rowTop);
+            } else if (rowTop + rowHeight > scrollY + windowHeight) {
+                ImGui::SetScrollY(rowTop + rowHeight - windowHeight);
+            }
+            _scrollToSelected = false;
+        }
+
+        ImGuiListClipper clipper;
+        clipper.Begin(visibleCount, rowHeight);
+        while (clipper.Step()) {
+            for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++) {
+                ImGui::PushID(row);
+                if (ImGui::Selectable(_labels[_visible[row].index].c_str(), row == _selected)) {
+                    _selected = row;
+                }
+                ImGui::PopID();
+            }
+        }
+        clipper.End();
+        ImGui::EndChild();
+    }
+
+    void OnCustomProvide() override {
+        auto providerSize = ImGui::GetContentRegionAvail();
+        ImGui::PushStyleColor(ImGuiCol_Button, argConfig.colorDefault);
+        ImGui::PushStyleColor(ImGuiCol_ButtonActive, argConfig.colorDefault);
+        ImGui::PushStyleColor(ImGuiCol_ButtonHovered, argConfig.colorDefault);
+        ImGui::Button("Filter:", {providerSize.x * argConfig.customProviderButtonWidth, providerSize.y});
+        ImGui::PopStyleColor(3);
+
+        ImGui::SameLine();
+        ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x);
+        ImGui::SetKeyboardFocusHere();
+        ImGui::InputText("hotlineInput", this->_inputBuffer, IM_ARRAYSIZE(this->_inputBuffer), argConfig.inputTextFlags);
+    }
+
+    void OnApply() override {
+        if (_selected >= 0 && _selected < static_cast<int>(_visible.size())) {
+            this->_arg = _values[_visible[_selected].index];
+        } else {
+            if (!ProvideFromString(this->_inputBuffer)) {
+                // input stays open until value parses
+                this->_state = InProgress;
+            }
+        }
+    }
+
+    void OnReset() override {
+        this->_inputBuffer[0] = '\0';
+        _filterDirty = true;
+        _selected = 0;
+    }
+
+    virtual std::string ToString(const T &arg) = 0;
+
+    bool ProvideFromString(const std::string &str) override = 0;
+};
+
+struct StringSearchArgProvider : public SearchArgProvider<std::string> {
+    StringSearchArgProvider(const std::string &name, std::vector<std::string> values)
+            : SearchArgProvider<std::string>(name, std::move(values)) {}
+
+    StringSearchArgProvider(const std::string &name, std::function<std::vector<std::string>()> generator)
+            : SearchArgProvider<std::string>(name, std::move(generator)) {}
+
+    std::string ToString(const std::string &arg) override {
+        return arg;
+    }
+
+    bool ProvideFromString(const std::string &str) override {
+        _arg = str;
+        return true;
+    }
+};
@@ -0,0 +1,231 @@
+#include "CommandServer.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace hotline {
+
+    namespace {
+        // client sending a line longer than this is dropped, it is not a command
+        constexpr size_t maxLineSize = 64 * 1024;
+
+#if defined(MSG_NOSIGNAL)
+        constexpr int sendFlags = MSG_NOSIGNAL;
+#else
+        constexpr int sendFlags = 0;    // SO_NOSIGPIPE is set on accepted sockets instead
+#endif
+
+        bool SetNonBlocking(int fd) {
+            const int flags = fcntl(fd, F_GETFL, 0);
+            return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+        }
+
+        bool MakeAddress(const std::string &path, sockaddr_un &address) {
+            std::memset(&address, 0, sizeof(address));
+            address.sun_family = AF_UNIX;
+            if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+                return false;
+            }
+            std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+            return true;
+        }
+    }
+
+    CommandServer::CommandServer(ActionSetGroup &sets) : _sets(sets) {}
+
+    CommandServer::~CommandServer() {
+        Stop();
+    }
+
+    bool CommandServer::Start(const std::string &path) {
+        Stop();
+        sockaddr_un address;
+        if (!MakeAddress(path, address)) {
+            return false;
+        }
+        const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) {
+            return false;
+        }
+        if (bind(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0) {
+            if (errno != EADDRINUSE) {
+                close(fd);
+                return false;
+            }
+            // file is stale unless somebody still accepts on it
+            const int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+            const bool isLive = probe >= 0
+                                && connect(probe, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) == 0;
+            if (probe >= 0) {
+                close(probe);
+            }
+            if (isLive || unlink(path.c_str()) != 0
+                || bind(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0) {
+                close(fd);
+                return false;
+            }
+        }
+        if (listen(fd, 16) != 0 || !SetNonBlocking(fd)) {
+            close(fd);
+            unlink(path.c_str());
+            return false;
+        }
+        _listenFd = fd;
+        _path = path;
+        return true;
+    }
+
+    void CommandServer::Stop() {
+        for (auto &client: _clients) {
+            close(client.fd);
+        }
+        _clients.clear();
+        if (_listenFd >= 0) {
+            close(_listenFd);
+            unlink(_path.c_str());
+            _listenFd = -1;
+        }
+        _path.clear();
+    }
+
+    size_t CommandServer::Poll(size_t maxCommands) {
+        if (_listenFd < 0) {
+            return 0;
+        }
+        AcceptClients();
+
+        size_t executed = 0;
+        for (size_t i = 0; i < _clients.size();) {
+            Client &client = _clients[i];
+            bool keep = Receive(client);
+            executed += ExecuteLines(client, maxCommands - executed);
+            keep = Send(client) && keep;
+            // client which finished sending is answered first
+            if (keep && client.finished && client.output.empty()
+                && client.input.find('\n', client.inputStart) == std::string::npos) {
+                keep = false;
+            }
+            if (!keep) {
+                close(client.fd);
+                _clients.erase(_clients.begin() + static_cast<std::ptrdiff_t>(i));
+            } else {
+                i++;
+            }
+        }
+        return executed;
+    }
+
+    const char *CommandServer::GetStatusText(CommandStatus status) {
+        switch (status) {
+            case CommandStatus::Executed:
+                return "ok";
+            case CommandStatus::UnknownAction:
+                return "unknown";
+            case CommandStatus::Unavailable:
+                return "unavailable";
+            case CommandStatus::MissingArguments:
+                return "missing-arguments";
+            case CommandStatus::InvalidArguments:
+                return "invalid-arguments";
+            case CommandStatus::Busy:
+                return "busy";
+        }
+        return "unknown";
+    }
+
+    void CommandServer::AcceptClients() {
+        for (;;) {
+            const int fd = accept(_listenFd, nullptr, nullptr);
+            if (fd < 0) {
+                return;
+            }
+            if (!SetNonBlocking(fd)) {
+                close(fd);
+                continue;
+            }
+#if !defined(MSG_NOSIGNAL) && defined(SO_NOSIGPIPE)
+            const int noSigPipe = 1;
+            setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+#endif
+            Client client;
+            client.fd = fd;
+            _clients.push_back(std::move(client));
+        }
+    }
+
+    bool CommandServer::Receive(Client &client) {
+        char buffer[16 * 1024];
+        while (!client.finished) {
+            const ssize_t received = recv(client.fd, buffer, sizeof(buffer), 0);
+            if (received > 0) {
+                client.input.append(buffer, static_cast<size_t>(received));
+                // unexecuted lines beyond limit are kept, only a single endless line is refused
+                if (client.input.size() - client.inputStart > maxLineSize
+                    && client.input.find('\n', client.inputStart) == std::string::npos) {
+                    return false;
+                }
+                continue;
+            }
+            if (received == 0) {
+                // client finished sending, its lines are still executed and answered. Last line may
+                // miss its newline
+                client.finished = true;
+                if (client.input.size() > client.inputStart && client.input.back() != '\n') {
+                    client.input.push_back('\n');
+                }
+                return true;
+            }
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        }
+        return true;
+    }
+
+    size_t CommandServer::ExecuteLines(Client &client, size_t maxCommands) {
+        size_t executed = 0;
+        while (executed < maxCommands) {
+            const size_t end = client.input.find('\n', client.inputStart);
+            if (end == std::string::npos) {
+                break;
+            }
+            _command.assign(client.input, client.inputStart, end - client.inputStart);
+            client.inputStart = end + 1;
+            if (!_command.empty() && _command.back() == '\r') {
+                _command.pop_back();
+            }
+            if (_command.find_first_not_of(' ') == std::string::npos) {
+                continue;
+            }
+            client.output.append(GetStatusText(_sets.ExecuteCommand(_command)));
+            client.output.push_back('\n');
+            executed++;
+        }
+        // executed lines are dropped at once, not per line
+        if (client.inputStart > 0 && client.inputStart * 2 >= client.input.size()) {
+            client.input.erase(0, client.inputStart);
+            client.inputStart = 0;
+        }
+        return executed;
+    }
+
+    bool CommandServer::Send(Client &client) {
+        size_t sent = 0;
+        while (sent < client.output.size()) {
+            const ssize_t count = send(client.fd, client.output.data() + sent, client.output.size() - sent,
+                                       sendFlags);
+            if (count < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                    break;
+                }
+                return false;
+            }
+            sent += static_cast<size_t>(count);
+        }
+        client.output.erase(0, sent);
+        return true;
+    }
+
+}
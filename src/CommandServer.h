@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ActionSetGroup.h"
+
+namespace hotline {
+
+    // newline-delimited commands ("name arg1 arg2", as typed in palette) from local tools over a Unix domain
+    // socket. Sockets are non-blocking and served by Poll on UI thread, so actions run where they always do.
+    // Every non-empty line gets one reply line with its status, in order:
+    //   ok | unknown | unavailable | missing-arguments | invalid-arguments | busy
+    // POSIX only, built with HOTLINE_COMMAND_SERVER
+    class CommandServer {
+    public:
+        explicit CommandServer(ActionSetGroup &sets);
+        ~CommandServer();
+
+        CommandServer(const CommandServer &) = delete;
+        CommandServer &operator=(const CommandServer &) = delete;
+
+        // false if socket can't be created or path is served by another live server. File left by server
+        // which didn't stop cleanly is replaced
+        bool Start(const std::string &path);
+        void Stop();
+        bool IsRunning() const { return _listenFd >= 0; }
+
+        // accepts clients, executes complete lines received since last call and sends replies. At most
+        // maxCommands are executed per call, rest stays buffered for next one. Returns executed count
+        size_t Poll(size_t maxCommands = SIZE_MAX);
+
+        static const char *GetStatusText(CommandStatus status);
+
+    private:
+        struct Client {
+            int fd = -1;
+            std::string input;      // received bytes not yet executed
+            size_t inputStart = 0;  // executed lines end here
+            std::string output;     // replies not yet sent
+            bool finished = false;  // client shut down its sending side
+        };
+
+        void AcceptClients();
+        // false if connection failed or client misbehaved
+        bool Receive(Client &client);
+        size_t ExecuteLines(Client &client, size_t maxCommands);
+        bool Send(Client &client);
+
+        ActionSetGroup &_sets;
+        std::string _path;
+        int _listenFd = -1;
+        std::vector<Client> _clients;
+        std::string _command;
+    };
+
+}
@@ -0,0 +1,37 @@
+#include "FrameArena.h"
+
+#include <algorithm>
+
+namespace hotline {
+
+    FrameArena::FrameArena(size_t initialSize, std::pmr::memory_resource *upstream)
+            : _upstream(upstream), _blockSize(std::max<size_t>(initialSize, 1)) {
+        _block = _upstream->allocate(_blockSize, alignof(std::max_align_t));
+        _monotonic.emplace(_block, _blockSize, _upstream);
+    }
+
+    FrameArena::~FrameArena() {
+        _monotonic.reset();
+        _upstream->deallocate(_block, _blockSize, alignof(std::max_align_t));
+    }
+
+    void FrameArena::Reset() {
+        // overflow chunks are returned to upstream here
+        _monotonic.reset();
+        if (_peakBytes > _blockSize) {
+            _upstream->deallocate(_block, _blockSize, alignof(std::max_align_t));
+            // alignment padding takes some bytes over the peak
+            _blockSize = _peakBytes + _peakBytes / 8;
+            _block = _upstream->allocate(_blockSize, alignof(std::max_align_t));
+        }
+        _monotonic.emplace(_block, _blockSize, _upstream);
+        _usedBytes = 0;
+    }
+
+    void *FrameArena::do_allocate(size_t bytes, size_t alignment) {
+        _usedBytes += bytes;
+        _peakBytes = std::max(_peakBytes, _usedBytes);
+        return _monotonic->allocate(bytes, alignment);
+    }
+
+}
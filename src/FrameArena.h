@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <optional>
+
+namespace hotline {
+
+    // monotonic memory for data living one frame (scratch of searches, draw data). Deallocation is a no-op,
+    // everything is freed at once by Reset. Initial block grows to the peak usage of previous frames, so
+    // steady frames allocate nothing from upstream. Not thread-safe
+    class FrameArena : public std::pmr::memory_resource {
+    public:
+        explicit FrameArena(size_t initialSize = 64 * 1024,
+                            std::pmr::memory_resource *upstream = std::pmr::get_default_resource());
+        ~FrameArena() override;
+
+        FrameArena(const FrameArena &) = delete;
+        FrameArena &operator=(const FrameArena &) = delete;
+
+        // frees all memory handed out since previous Reset
+        void Reset();
+
+        size_t GetUsedBytes() const { return _usedBytes; }      // since previous Reset
+        size_t GetPeakBytes() const { return _peakBytes; }      // over all frames
+        size_t GetBlockSize() const { return _blockSize; }
+
+    private:
+        void *do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void *, size_t, size_t) override {}
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+
+        std::pmr::memory_resource *_upstream;
+        void *_block = nullptr;
+        size_t _blockSize = 0;
+        size_t _usedBytes = 0;
+        size_t _peakBytes = 0;
+        std::optional<std::pmr::monotonic_buffer_resource> _monotonic;
+    };
+
+}
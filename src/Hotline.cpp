@@ -1,33 +1,45 @@
 #include "Hotline.h"
 
+#include <algorithm>
+#include <cstring>
 #include <memory>
-#include <sstream>
+#include <string_view>
 #include <iostream>
-#include "ActionSet.h"
+#include "ActionSetGroup.h"
+#include "search/SearchBudget.h"
+#include "search/Utf8.h"
+#include "TraceRecorder.h"
 
 namespace hotline {
-	std::vector<ActionVariant> &Hotline::GetCurrentVariantContainer() {
-        if (!hotlineConfig.showRecentActions) {
-            return _queryVariants;
-        }
-        return _input.empty() ? _recentActions : _queryVariants;
+	bool Hotline::IsShowingRecentActions() const {
+        return hotlineConfig.showRecentActions && _input.empty();
+    }
+
+	size_t Hotline::GetCurrentVariantCount() const {
+        return IsShowingRecentActions() ? _recentActions.size() : _queryResults.Size();
     }
 
 	std::string& Hotline::GetHeader() {
-        if(!_queryVariants.empty()) return hotlineConfig.listHeaderSearch;
+        if(!_queryResults.IsEmpty()) return hotlineConfig.listHeaderSearch;
         if(hotlineConfig.showRecentActions && !_recentActions.empty()) return hotlineConfig.listHeaderRecents;
         return hotlineConfig.listHeaderNone;
 	}
 
-	void Hotline::Draw(ActionSet& set) {
-        HandleKeyInput(set);
+	void Hotline::Draw(ActionSetGroup& sets) {
+        HandleKeyInput(sets);
 
         OnPreWindow();
         OnWindowBegin();
 
         OnTextInput();
-        HandleTextInput(_inputBuffer, set);
-        DrawVariants(GetCurrentVariantContainer());
+        HandleTextInput(sets);
+        // completion and header depend on input, results and selection only, idle frames just draw
+        if (_viewGeneration != _updatedViewGeneration) {
+            _updatedViewGeneration = _viewGeneration;
+            UpdateArgumentCompletion(sets);
+            _header = &GetHeader();
+        }
+        DrawVariants(sets);
 
         OnWindowEnd();
         OnPostWindow();
@@ -41,7 +53,13 @@ namespace hotline {
 
         auto cursorBefore = ImGui::GetCursorPos();
         ImGui::PushStyleColor(ImGuiCol_FrameBg, hotlineConfig.inputBgColor);
-        ImGui::InputText("##input", _inputBuffer, IM_ARRAYSIZE(_inputBuffer), hotlineConfig.inputTextFlags);
+        // edits by typing, clearing with escape and accepted completions are all reported here
+        if (ImGui::InputText("##input", _inputBuffer, IM_ARRAYSIZE(_inputBuffer),
+                             hotlineConfig.inputTextFlags | ImGuiInputTextFlags_CallbackCompletion,
+                             &Hotline::InputTextCallback, this)) {
+            _inputGeneration++;
+            HOTLINE_TRACE_INSTANT("input", "keystroke", "length", std::strlen(_inputBuffer));
+        }
         ImGui::PopStyleColor();
         auto cursorAfter = ImGui::GetCursorPos();
 
@@ -53,18 +71,21 @@ namespace hotline {
         }
 
         ImGui::SetWindowFontScale(hotlineConfig.windowHeaderScale * hotlineConfig.scaleFactor);
-        if (!GetHeader().empty()) {
-            ImGui::Text(GetHeader().c_str());
+        if (_header && !_header->empty()) {
+            ImGui::TextUnformatted(_header->c_str(), _header->c_str() + _header->size());
         }
         ImGui::SetWindowFontScale(hotlineConfig.windowFontScale * hotlineConfig.scaleFactor);
     }
 
-    void Hotline::OnWindowBegin() const {
-        auto io = ImGui::GetIO();
-        ImVec2 position{io.DisplaySize.x * hotlineConfig.windowPos.x, io.DisplaySize.y * hotlineConfig.windowPos.y};
-        ImVec2 size{io.DisplaySize.x * hotlineConfig.windowSize.x, io.DisplaySize.y * hotlineConfig.windowSize.y};
-        ImGui::SetNextWindowPos(position, ImGuiCond_Always, hotlineConfig.windowPivot);
-        ImGui::SetNextWindowSize(size);
+    void Hotline::OnWindowBegin() {
+        const ImGuiIO &io = ImGui::GetIO();
+        if (io.DisplaySize.x != _layoutDisplaySize.x || io.DisplaySize.y != _layoutDisplaySize.y) {
+            _layoutDisplaySize = io.DisplaySize;
+            _windowPosition = {io.DisplaySize.x * hotlineConfig.windowPos.x, io.DisplaySize.y * hotlineConfig.windowPos.y};
+            _windowSize = {io.DisplaySize.x * hotlineConfig.windowSize.x, io.DisplaySize.y * hotlineConfig.windowSize.y};
+        }
+        ImGui::SetNextWindowPos(_windowPosition, ImGuiCond_Always, hotlineConfig.windowPivot);
+        ImGui::SetNextWindowSize(_windowSize);
         ImGui::PushStyleColor(ImGuiCol_WindowBg, hotlineConfig.bgColor);
         ImGui::Begin("HotlineWindow", 0, hotlineConfig.windowFlags);
         ImGui::PopStyleColor();
@@ -86,169 +107,334 @@ namespace hotline {
         _actionArguments.clear();
         _selectionIndex = 0;
         _inputBuffer[0] = '\0';
-        _queryVariants.clear();
+        _inputGeneration++;
+        _viewGeneration++;
+        _queryResults.Clear();
+        _searchPending = false;
+        _argumentCompletions.clear();
+        _completionActionName.clear();
+        _completionPrefix.clear();
     }
 
 	void Hotline::SetExitCallback(std::function<void()> callback) {
         _onExitCallback = callback;
 	}
 
-	void Hotline::HandleKeyInput(ActionSet& set) {
+	void Hotline::HandleKeyInput(ActionSetGroup& sets) {
         if (ImGui::IsKeyPressed(ImGuiKey_Escape, false) && _input.empty()) {
             _onExitCallback();
         }
 
+        // tab accepts argument completion instead, see InputTextCallback
+        const bool tabSelects = _argumentCompletions.empty();
         if (ImGui::IsKeyPressed(ImGuiKey_DownArrow)
-            || (ImGui::IsKeyPressed(ImGuiKey_Tab) && !ImGui::IsKeyDown(ImGuiKey_LeftShift))) {
+            || (tabSelects && ImGui::IsKeyPressed(ImGuiKey_Tab) && !ImGui::IsKeyDown(ImGuiKey_LeftShift))) {
             _selectionIndex++;
-            if (_selectionIndex >= GetCurrentVariantContainer().size()) {
+            if (_selectionIndex >= GetCurrentVariantCount()) {
                 _selectionIndex = 0;
             }
+            _viewGeneration++;
         }
 
         if (ImGui::IsKeyPressed(ImGuiKey_UpArrow)
-            || (ImGui::IsKeyPressed(ImGuiKey_Tab) && ImGui::IsKeyDown(ImGuiKey_LeftShift))) {
+            || (tabSelects && ImGui::IsKeyPressed(ImGuiKey_Tab) && ImGui::IsKeyDown(ImGuiKey_LeftShift))) {
             _selectionIndex--;
             if (_selectionIndex < 0) {
-                _selectionIndex = GetCurrentVariantContainer().size() - 1;
+                _selectionIndex = GetCurrentVariantCount() - 1;
             }
+            _viewGeneration++;
         }
 
         if (ImGui::IsKeyPressed(ImGuiKey_Enter, false)) {
-            HandleApplyCommand(set);
+            HandleApplyCommand(sets);
         }
     }
 
-    void Hotline::HandleTextInput(const std::string &input, ActionSet& set) {
-        if (_input != input) {
-            _input = input;
+    void Hotline::HandleTextInput(ActionSetGroup& sets) {
+        // input is compared and split only after an edit, not every frame
+        if (_inputGeneration != _handledInputGeneration) {
+            _handledInputGeneration = _inputGeneration;
+            _input = _inputBuffer;
+            _viewGeneration++;
             SplitInput();
             if (_prevActionName != _currentActionName) {
                 _prevActionName = _currentActionName;
                 _selectionIndex = 0;
-                _queryVariants = set.FindVariants(_currentActionName);
+                if (hotlineConfig.searchTimeBudgetUs > 0 || hotlineConfig.searchItemBudget > 0) {
+                    _searchPending = true;
+                } else {
+                    sets.FindVariants(_currentActionName, hotlineConfig.variantLimit, _queryResults);
+                }
             }
         }
+        ContinueSearch(sets);
+    }
+
+    void Hotline::ContinueSearch(ActionSetGroup& sets) {
+        if (!_searchPending) {
+            return;
+        }
+        SearchBudget budget(hotlineConfig.searchItemBudget,
+                            std::chrono::microseconds(hotlineConfig.searchTimeBudgetUs));
+        _searchPending = !sets.FindVariantsStep(_currentActionName, hotlineConfig.variantLimit, budget,
+                                                _queryResults);
+        _viewGeneration++;
+        // better variants found later push selected one down, selection stays on the same row
+        if (_selectionIndex >= static_cast<int>(_queryResults.Size())) {
+            _selectionIndex = 0;
+        }
+    }
+
+    void Hotline::UpdateArgumentCompletion(ActionSetGroup& sets) {
+        if (!hotlineConfig.argumentCompletion || !_typingArguments || _queryResults.IsEmpty()) {
+            if (!_argumentCompletions.empty() || !_completionActionName.empty()) {
+                _argumentCompletions.clear();
+                _completionActionName.clear();
+            }
+            return;
+        }
+
+        // trailing space or separator means next argument is started but nothing is typed yet
+        const bool argumentStarted = _input.back() == ' ' || _input.back() == hotlineConfig.argumentSeparator
+                                     || _actionArguments.empty();
+        const size_t argIdx = argumentStarted ? _actionArguments.size() : _actionArguments.size() - 1;
+        static const std::string emptyPrefix;
+        const std::string &prefix = argumentStarted ? emptyPrefix : _actionArguments.back();
+        const VariantHandle &selected = _queryResults[_selectionIndex];
+        const std::string_view actionName = sets.GetVariantName(selected, _queryResults);
+        const size_t scope = selected.scope;
+
+        if (argIdx == _completionArgIdx && scope == _completionScope && actionName == _completionActionName
+            && prefix == _completionPrefix) {
+            return;
+        }
+
+        _completionActionName.assign(actionName);
+        _completionScope = scope;
+        _completionArgIdx = argIdx;
+        _completionArgCount = sets.GetVariantArguments(selected).size();
+        _completionPrefix = prefix;
+        sets.CompleteArgument(scope, _completionActionName, argIdx, prefix, _argumentCompletions,
+                              hotlineConfig.argumentCompletionLimit);
+    }
+
+    int Hotline::InputTextCallback(ImGuiInputTextCallbackData* data) {
+        if (data->EventFlag == ImGuiInputTextFlags_CallbackCompletion) {
+            static_cast<Hotline*>(data->UserData)->ApplyArgumentCompletion(data);
+        }
+        return 0;
+    }
+
+    void Hotline::ApplyArgumentCompletion(ImGuiInputTextCallbackData* data) {
+        if (_argumentCompletions.empty()) {
+            return;
+        }
+
+        int tokenStart = data->BufTextLen;
+        while (tokenStart > 0 && data->Buf[tokenStart - 1] != ' '
+               && !(hotlineConfig.multiTokenQuery && data->Buf[tokenStart - 1] == hotlineConfig.argumentSeparator)) {
+            tokenStart--;
+        }
+        data->DeleteChars(tokenStart, data->BufTextLen - tokenStart);
+        data->InsertChars(tokenStart, _argumentCompletions.front().c_str());
+
+        if (_completionArgIdx + 1 < _completionArgCount) {
+            data->InsertChars(data->BufTextLen, " ");
+        }
     }
 
-    void Hotline::HandleApplyCommand(ActionSet& set) {
+    void Hotline::HandleApplyCommand(ActionSetGroup& sets) {
         ActionStartResult applyCommandResult = Success;
         const bool applyRecentAction = hotlineConfig.showRecentActions && _input.empty() && !_recentActions.empty();
-        const bool haveSearchAction = !_queryVariants.empty();
+        const bool haveSearchAction = !_queryResults.IsEmpty();
+        // exactly typed name or alias is executed from hash lookup, whatever search has found by now
+        ActionVariant exactVariant;
         if (applyRecentAction) {
-            ExecuteRecentAction(set);
+            ExecuteRecentAction(sets);
+        } else if (_selectionIndex == 0 && sets.FindExactVariant(_currentActionName, exactVariant)) {
+            ExecuteSearchAction(sets, exactVariant);
         } else if (haveSearchAction) {
-            ExecuteSearchAction(set);
+            ActionVariant selected;
+            sets.ResolveVariant(_queryResults[_selectionIndex], _queryResults, selected);
+            ExecuteSearchAction(sets, selected);
         }
     }
 
-    void Hotline::ExecuteSearchAction(ActionSet &set) {
-        auto actionName = _queryVariants[_selectionIndex].actionName;
+    void Hotline::ExecuteSearchAction(ActionSetGroup &sets, const ActionVariant &variant) {
+        auto actionName = variant.actionName;
         auto actionArgs = _actionArguments;
+        const size_t scope = variant.scope;
         _currentActionName = actionName;
-        set.ExecuteAction(actionName, _actionArguments);
+        _viewGeneration++;
+        sets.ExecuteAction(scope, actionName, _actionArguments);
         auto executedAction = std::find_if(_recentActions.begin(), _recentActions.end(),
-                                           [&actionName, &actionArgs](const ActionVariant &variant) {
-                                               return (variant.actionName == actionName) &&
-                                                      (variant.actionArguments == actionArgs);
+                                           [&actionName, &actionArgs, scope](const ActionVariant &recent) {
+                                               return (recent.actionName == actionName) &&
+                                                      (recent.actionArguments == actionArgs) &&
+                                                      (recent.scope == scope);
                                            });
         if (executedAction != _recentActions.end()) {
             std::rotate(_recentActions.begin(), executedAction, executedAction + 1);
         } else {
-            if (_actionArguments.size() > _queryVariants[_selectionIndex].actionArguments.size()) {
-                _actionArguments.resize(_queryVariants[_selectionIndex].actionArguments.size());
+            if (_actionArguments.size() > variant.actionArguments.size()) {
+                _actionArguments.resize(variant.actionArguments.size());
             }
             ActionVariant var;
-            var.actionName = _queryVariants[_selectionIndex].actionName;
+            var.actionName = actionName;
             var.actionArguments = _actionArguments;
+            var.scope = scope;
             _recentActions.push_back(var);
             std::rotate(_recentActions.begin(), _recentActions.end() - 1, _recentActions.end());
         }
     }
 
-    void Hotline::ExecuteRecentAction(ActionSet &set) {
+    void Hotline::ExecuteRecentAction(ActionSetGroup &sets) {
         _currentActionName = _recentActions[_selectionIndex].actionName;
-        set.ExecuteAction(_recentActions[_selectionIndex].actionName,
-                                               _recentActions[_selectionIndex].actionArguments);
+        _viewGeneration++;
+        sets.ExecuteAction(_recentActions[_selectionIndex].scope, _recentActions[_selectionIndex].actionName,
+                           _recentActions[_selectionIndex].actionArguments);
         auto currentCommandIter = _recentActions.begin() + _selectionIndex;
         std::rotate(_recentActions.begin(), currentCommandIter, currentCommandIter + 1);
     }
 
     void Hotline::SplitInput() {
-        std::istringstream iss(_input);
-        std::getline(iss, _currentActionName, ' ');
+        const char separator = hotlineConfig.multiTokenQuery ? hotlineConfig.argumentSeparator : ' ';
+        // leading @category and #tag filters belong to query, also when space starts arguments
+        size_t nameStart = 0;
+        if (!hotlineConfig.multiTokenQuery) {
+            while (nameStart < _input.size() && (_input[nameStart] == '@' || _input[nameStart] == '#')) {
+                nameStart = _input.find_first_not_of(' ', _input.find(' ', nameStart));
+            }
+        }
+        const size_t separatorPos = _input.find(separator, nameStart);
+        _typingArguments = separatorPos != std::string::npos;
+        _currentActionName.assign(_input, 0, separatorPos);
+        std::string_view arguments;
+        if (_typingArguments) {
+            arguments = std::string_view(_input).substr(separatorPos + 1);
+            if (hotlineConfig.multiTokenQuery) {
+                arguments.remove_prefix(std::min(arguments.find_first_not_of(' '), arguments.size()));
+            }
+        }
 
-        std::string word;
-        int argIndex = 0;
-        while (std::getline(iss, word, ' ')) {
+        // words between single spaces, empty ones too, except after trailing space
+        size_t argIndex = 0;
+        size_t begin = 0;
+        while (begin < arguments.size()) {
+            const size_t end = std::min(arguments.find(' ', begin), arguments.size());
+            const std::string_view word = arguments.substr(begin, end - begin);
             if (argIndex >= _actionArguments.size()) {
-                _actionArguments.push_back(word);
+                _actionArguments.emplace_back(word);
             } else if (word != _actionArguments[argIndex]) {
-                _actionArguments[argIndex] = word;
+                _actionArguments[argIndex].assign(word);
             }
             argIndex++;
+            begin = end + 1;
         }
-        while (_actionArguments.size() != argIndex) {
-            _actionArguments.pop_back();
-        }
+        _actionArguments.resize(argIndex);
     }
 
-    void Hotline::DrawVariants(const std::vector<ActionVariant> variants) {
-        for (size_t variantIndex = 0; variantIndex < variants.size(); variantIndex++) {
+    void Hotline::DrawVariants(ActionSetGroup& sets) {
+        const bool recent = IsShowingRecentActions();
+        const size_t count = GetCurrentVariantCount();
+        for (size_t variantIndex = 0; variantIndex < count; variantIndex++) {
+            // query results are resolved to strings of their sets only here
+            const VariantHandle *handle = recent ? nullptr : &_queryResults[variantIndex];
+            const std::string_view name = recent ? std::string_view(_recentActions[variantIndex].actionName)
+                                                 : sets.GetVariantName(*handle, _queryResults);
+
             if (variantIndex == _selectionIndex) {
                 ImGui::PushStyleColor(ImGuiCol_ChildBg, hotlineConfig.variantBackground);
             }
 
-            ImVec2 textSize = ImGui::CalcTextSize(variants[variantIndex].actionName.c_str());
-            ImVec2 childSize = {ImGui::GetContentRegionAvail().x, textSize.y * hotlineConfig.variantHeightMultiplier};
-            ImGui::BeginChild(("action" + std::to_string(variantIndex)).c_str(), childSize, 0, hotlineConfig.variantFlags);
+            // names are single line, so row height needs no text measuring
+            const float textHeight = ImGui::GetTextLineHeight();
+            ImVec2 childSize = {ImGui::GetContentRegionAvail().x, textHeight * hotlineConfig.variantHeightMultiplier};
+            ImGui::PushID(static_cast<int>(variantIndex));
+            ImGui::BeginChild("action", childSize, 0, hotlineConfig.variantFlags);
             if (variantIndex == _selectionIndex) {
                 ImGui::PopStyleColor();
             }
 
-            ImVec2 textPosition{hotlineConfig.variantTextHorOffset, (ImGui::GetContentRegionAvail().y - textSize.y) * 0.5f};
+            ImVec2 textPosition{hotlineConfig.variantTextHorOffset, (ImGui::GetContentRegionAvail().y - textHeight) * 0.5f};
             ImGui::SetCursorPos(textPosition);
-            DrawVariant(variants[variantIndex]);
+            if (recent) {
+                const ActionVariant &variant = _recentActions[variantIndex];
+                DrawVariant(name, variant.positions.data(), variant.positions.size(), variant.actionArguments,
+                            variantIndex == _selectionIndex);
+            } else {
+                DrawVariant(name, _queryResults.GetPositions(*handle), handle->positionCount,
+                            sets.GetVariantArguments(*handle), variantIndex == _selectionIndex);
+            }
             ImGui::EndChild();
+            ImGui::PopID();
+        }
+    }
+
+    void Hotline::DrawVariantNameRun(std::string_view run, bool matched) {
+        if (matched) {
+            ImGui::PushStyleColor(ImGuiCol_Text, hotlineConfig.variantMatchLettersColor);
+        }
+        ImGui::TextUnformatted(run.data(), run.data() + run.size());
+        if (matched) {
+            ImGui::PopStyleColor();
         }
     }
 
-    void Hotline::DrawVariant(const ActionVariant &variant) {
+    template<typename Labels>
+    void Hotline::DrawVariant(std::string_view name, const int *positions, size_t positionCount,
+                              const Labels &arguments, bool isSelected) {
         auto childSize = ImGui::GetContentRegionAvail();
-        if (variant.positions.empty()) {
-            ImGui::Text(variant.actionName.c_str());
+        if (positionCount == 0) {
+            ImGui::TextUnformatted(name.data(), name.data() + name.size());
         } else {
-            int highlightIdx = 0;
-            char scoreBuf[3] = "x\0";
-
-            for (size_t i = 0; i < variant.actionName.size(); i++) {
-                scoreBuf[0] = variant.actionName[i];
-                if (highlightIdx < variant.positions.size() &&
-                    i == variant.positions[highlightIdx]) {
-                    ImGui::TextColored(hotlineConfig.variantMatchLettersColor, scoreBuf);
+            // positions are byte offsets of code points, so runs of matched and unmatched
+            // code points are drawn without splitting multibyte characters
+            size_t highlightIdx = 0;
+            size_t runStart = 0;
+            bool runMatched = false;
+            for (size_t i = 0; i < name.size(); i = NextCodePoint(name, i)) {
+                const bool matched = highlightIdx < positionCount
+                                     && i == static_cast<size_t>(positions[highlightIdx]);
+                if (matched) {
                     highlightIdx++;
-                } else {
-                    ImGui::Text(scoreBuf);
                 }
-                if (i != variant.actionName.size() - 1) {
+                if (i != 0 && matched != runMatched) {
+                    DrawVariantNameRun(name.substr(runStart, i - runStart), runMatched);
                     ImGui::SameLine(0, 0);
+                    runStart = i;
                 }
+                runMatched = matched;
             }
+            DrawVariantNameRun(name.substr(runStart), runMatched);
         }
-		if (_currentActionName.size() < _input.size() || _queryVariants.empty())
+		if (_typingArguments || _queryResults.IsEmpty())
 		{
-			for (int i = 0; i < variant.actionArguments.size(); i++)
+			for (int i = 0; i < arguments.size(); i++)
 			{
 				float offsetFromStart = i == 0 ? childSize.x * 0.4f : 0.f;
 				ImGui::SameLine(offsetFromStart, -2);
-				ImGui::TextColored(hotlineConfig.variantArgumentsColor, variant.actionArguments[i].c_str());
-				if (i < _actionArguments.size())
+				const std::string_view label = arguments[i];
+				ImGui::TextColored(hotlineConfig.variantArgumentsColor, "%.*s", static_cast<int>(label.size()), label.data());
+				const bool isTyped = i < _actionArguments.size();
+				const bool isCompleted = isSelected && i == _completionArgIdx && !_argumentCompletions.empty();
+				if (isTyped || isCompleted)
 				{
 					ImGui::SameLine(0, 0);
 					ImGui::TextColored(hotlineConfig.variantArgumentsColor, ":");
+				}
+				if (isTyped)
+				{
 					ImGui::SameLine(0, 0);
 					ImGui::TextColored(hotlineConfig.variantInputColor, _actionArguments[i].c_str());
 				}
+				if (isCompleted)
+				{
+					const std::string &completion = _argumentCompletions.front();
+					ImGui::SameLine(0, 0);
+					ImGui::TextColored(hotlineConfig.variantCompletionColor, "%s",
+									   completion.c_str() + std::min(_completionPrefix.size(), completion.size()));
+				}
 				ImGui::SameLine(0, 0);
 			}
 		}
@@ -2,17 +2,29 @@
 
 #include <memory>
 #include <string>
+#include <string_view>
 #include "imgui.h"
 #include "ActionSet.h"
 #include "IActionFrontend.h"
 
 namespace hotline {
-    class ActionSet;
+    class ActionSetGroup;
 
     struct Config {
         //  main
         ImGuiKey toggleKey = ImGuiKey_F1;
         bool showRecentActions = true;
+        size_t variantLimit = 20;   // best variants shown for query, over all enabled action sets
+        // query words are matched in any order ("export mesh" finds MeshExport), arguments are typed
+        // after argumentSeparator. Otherwise arguments start after first space following action name,
+        // @category and #tag filters can be typed before the name then ("@test #args par")
+        bool multiTokenQuery = false;
+        char argumentSeparator = ':';
+        // big catalogues may be searched over several frames (builds without threads, e.g. Emscripten):
+        // each frame scans for up to searchTimeBudgetUs microseconds or searchItemBudget names and shows
+        // best variants found so far. Both 0 search whole catalogue at once
+        int searchTimeBudgetUs = 0;
+        size_t searchItemBudget = 0;
 
         //  window
         float scaleFactor = 1.0f;
@@ -45,34 +57,51 @@ namespace hotline {
         ImVec4 variantMatchLettersColor = {0.996f, 0.447f, 0.298f, 1.0f};
         ImVec4 variantArgumentsColor = {0.749f, 0.855f, 0.655f, 0.6f};
         ImVec4 variantInputColor = {0.749f, 0.855f, 0.655f, 1.0f};
+        ImVec4 variantCompletionColor = {0.749f, 0.855f, 0.655f, 0.35f};
+        //  argument completion, accepted with tab
+        bool argumentCompletion = true;
+        size_t argumentCompletionLimit = 8;
         const ImVec4 bgColor = {0.15f,0.15f,0.15f,1.f};
         const ImVec4 inputBgColor = {0.15f,0.15f,0.15f,1.f};
         const ImVec4 headerColor = {0.4f,0.4f,0.4f,1.f};
     };
 
-    static Config hotlineConfig;
+    // one instance for all translation units, changes made by application are seen by Hotline.cpp
+    inline Config hotlineConfig;
 
     class Hotline : public IActionFrontend {
     public:
 		~Hotline() override = default;
 
-        void Draw(ActionSet& set) override;
+        void Draw(ActionSetGroup& sets) override;
 		void Reset() override;
         void SetExitCallback(std::function<void()> callback) override;
     protected:
-        std::vector<ActionVariant> &GetCurrentVariantContainer();
+        // history is shown while nothing is typed, otherwise query results
+        bool IsShowingRecentActions() const;
+        size_t GetCurrentVariantCount() const;
 
         std::string &GetHeader();
 
-        void HandleKeyInput(ActionSet& set);
+        void HandleKeyInput(ActionSetGroup& sets);
 
-        void HandleTextInput(const std::string &input, ActionSet& set);
+        void HandleTextInput(ActionSetGroup& sets);
 
-        void HandleApplyCommand(ActionSet& set);
+        void ContinueSearch(ActionSetGroup& sets);
 
-        void DrawVariants(const std::vector<ActionVariant> variants);
+        void HandleApplyCommand(ActionSetGroup& sets);
 
-        void DrawVariant(const ActionVariant &variant);
+        void DrawVariants(ActionSetGroup& sets);
+
+        // arguments: labels of query result or values of recent action
+        template<typename Labels>
+        void DrawVariant(std::string_view name, const int *positions, size_t positionCount, const Labels &arguments,
+                         bool isSelected);
+        void DrawVariantNameRun(std::string_view run, bool matched);
+
+        void UpdateArgumentCompletion(ActionSetGroup& sets);
+
+        static int InputTextCallback(ImGuiInputTextCallbackData* data);
 
         char _inputBuffer[128] = "";
     private:
@@ -82,10 +111,32 @@ namespace hotline {
         std::string _prevActionName;
         std::string _currentActionName;
         std::vector<std::string> _actionArguments;
-
-        std::vector<ActionVariant> _queryVariants;
+        bool _typingArguments = false;
+        bool _searchPending = false;    // budgeted search goes on in next frames
+
+        // bumped on every edit of _inputBuffer, input is handled only when it changes
+        uint64_t _inputGeneration = 0;
+        uint64_t _handledInputGeneration = 0;
+        // bumped when input, results or selection change, header and completion are updated only then
+        uint64_t _viewGeneration = 1;
+        uint64_t _updatedViewGeneration = 0;
+        const std::string *_header = nullptr;
+        // window placement, recomputed when display size changes
+        ImVec2 _layoutDisplaySize = {-1.f, -1.f};
+        ImVec2 _windowPosition;
+        ImVec2 _windowSize;
+
+        VariantResults _queryResults;   // strings are resolved by sets on draw
         std::vector<ActionVariant> _recentActions;
 
+        // completions of argument under cursor for selected variant, best first
+        std::vector<std::string> _argumentCompletions;
+        std::string _completionActionName;
+        std::string _completionPrefix;
+        size_t _completionArgIdx = 0;
+        size_t _completionArgCount = 0;     // arguments of completed action
+        size_t _completionScope = 0;
+
         std::function<void()> _onExitCallback;
 
         void SplitInput();
@@ -94,14 +145,16 @@ namespace hotline {
 
         void OnPostWindow() const;
 
-        void OnWindowBegin() const;
+        void OnWindowBegin();
 
         void OnTextInput();
 
         void OnWindowEnd() const;
 
-        void ExecuteRecentAction(ActionSet &set);
+        void ExecuteRecentAction(ActionSetGroup &sets);
+
+        void ExecuteSearchAction(ActionSetGroup &sets, const ActionVariant &variant);
 
-        void ExecuteSearchAction(ActionSet &set);
+        void ApplyArgumentCompletion(ImGuiInputTextCallbackData* data);
     };
 }
\ No newline at end of file
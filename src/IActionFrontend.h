@@ -2,13 +2,13 @@
 #include <functional>
 
 namespace hotline {
-	class ActionSet;
+	class ActionSetGroup;
 
 	class IActionFrontend {
 	public:
 		virtual ~IActionFrontend() = default;
 
-		virtual void Draw(ActionSet& set) = 0;
+		virtual void Draw(ActionSetGroup& sets) = 0;
 		virtual void Reset() = 0;
 		virtual void SetExitCallback(std::function<void()> callback) = 0;
 	};
@@ -17,6 +17,6 @@ namespace hotline {
 	public:
 		virtual ~IProviderFrontend() = default;
 
-		virtual void Draw(ActionSet& set) = 0;
+		virtual void Draw(ActionSetGroup& sets) = 0;
 	};
 }
\ No newline at end of file
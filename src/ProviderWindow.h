@@ -30,7 +30,7 @@ namespace hotline {
 	public:
 		~ProviderWindow() override = default;
 
-		void Draw(ActionSet& set) override;
+		void Draw(ActionSetGroup& sets) override;
 	};
 }
 
@@ -0,0 +1,188 @@
+#include "TraceRecorder.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+
+namespace hotline {
+
+    namespace {
+        void WriteEscaped(std::ostream &out, std::string_view text) {
+            for (const char c: text) {
+                if (c == '"' || c == '\\') {
+                    out << '\\' << c;
+                } else if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    out << escaped;
+                } else {
+                    out << c;
+                }
+            }
+        }
+
+        // trace timestamps are microseconds
+        void WriteMicroseconds(std::ostream &out, uint64_t nanoseconds) {
+            char text[32];
+            std::snprintf(text, sizeof(text), "%" PRIu64 ".%03" PRIu64, nanoseconds / 1000, nanoseconds % 1000);
+            out << text;
+        }
+    }
+
+    TraceRecorder::ThreadBuffer::ThreadBuffer(size_t capacity, int id)
+            : slots(std::make_unique<Slot[]>(capacity)), mask(capacity - 1), id(id) {}
+
+    TraceRecorder &TraceRecorder::Get() {
+        static TraceRecorder recorder;
+        return recorder;
+    }
+
+    TraceRecorder::TraceRecorder() : _epoch(std::chrono::steady_clock::now()) {}
+
+    void TraceRecorder::SetThreadCapacity(size_t events) {
+        size_t capacity = 1;
+        while (capacity < events) {
+            capacity *= 2;
+        }
+        std::lock_guard<std::mutex> lock(_threadsMutex);
+        _threadCapacity = capacity;
+    }
+
+    void TraceRecorder::SetThreadName(const char *name) {
+        GetThreadBuffer().name.store(name, std::memory_order_relaxed);
+    }
+
+    uint64_t TraceRecorder::Now() const {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - _epoch).count());
+    }
+
+    void TraceRecorder::Complete(const char *category, std::string_view name, uint64_t start, uint64_t end,
+                                 const char *argName, int64_t value) {
+        if (IsEnabled()) {
+            Record('X', category, name, start, end - start, argName, value);
+        }
+    }
+
+    void TraceRecorder::Instant(const char *category, std::string_view name, const char *argName, int64_t value) {
+        if (IsEnabled()) {
+            Record('i', category, name, Now(), 0, argName, value);
+        }
+    }
+
+    void TraceRecorder::Counter(const char *category, std::string_view name, int64_t value) {
+        if (IsEnabled()) {
+            Record('C', category, name, Now(), 0, "value", value);
+        }
+    }
+
+    void TraceRecorder::Clear() {
+        _clearedAt.store(Now(), std::memory_order_relaxed);
+    }
+
+    TraceRecorder::ThreadBuffer &TraceRecorder::GetThreadBuffer() {
+        // buffer is registered on first event of the thread, only this takes a lock
+        thread_local std::shared_ptr<ThreadBuffer> buffer;
+        if (!buffer) {
+            std::lock_guard<std::mutex> lock(_threadsMutex);
+            buffer = std::make_shared<ThreadBuffer>(_threadCapacity, static_cast<int>(_threads.size()) + 1);
+            _threads.push_back(buffer);
+        }
+        return *buffer;
+    }
+
+    void TraceRecorder::Record(char phase, const char *category, std::string_view name, uint64_t timestamp,
+                               uint64_t duration, const char *argName, int64_t value) {
+        ThreadBuffer &buffer = GetThreadBuffer();
+        const uint64_t position = buffer.head.load(std::memory_order_relaxed);
+        Slot &slot = buffer.slots[position & buffer.mask];
+        // seqlock: odd sequence tells readers the slot is being overwritten
+        slot.sequence.store(2 * position + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.category.store(category, std::memory_order_relaxed);
+        slot.name.store(name.data(), std::memory_order_relaxed);
+        slot.nameSize.store(name.size(), std::memory_order_relaxed);
+        slot.argName.store(argName, std::memory_order_relaxed);
+        slot.value.store(value, std::memory_order_relaxed);
+        slot.timestamp.store(timestamp, std::memory_order_relaxed);
+        slot.duration.store(duration, std::memory_order_relaxed);
+        slot.phase.store(phase, std::memory_order_relaxed);
+        slot.sequence.store(2 * (position + 1), std::memory_order_release);
+        buffer.head.store(position + 1, std::memory_order_release);
+    }
+
+    void TraceRecorder::WriteJson(std::ostream &out) const {
+        std::vector<std::shared_ptr<ThreadBuffer>> threads;
+        {
+            std::lock_guard<std::mutex> lock(_threadsMutex);
+            threads = _threads;
+        }
+        const uint64_t clearedAt = _clearedAt.load(std::memory_order_relaxed);
+
+        out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        bool first = true;
+        for (const auto &thread: threads) {
+            if (const char *name = thread->name.load(std::memory_order_relaxed)) {
+                out << (first ? "" : ",") << "\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":"
+                    << thread->id << ",\"args\":{\"name\":\"";
+                WriteEscaped(out, name);
+                out << "\"}}";
+                first = false;
+            }
+
+            const uint64_t head = thread->head.load(std::memory_order_acquire);
+            const uint64_t capacity = thread->mask + 1;
+            for (uint64_t position = head > capacity ? head - capacity : 0; position < head; position++) {
+                const Slot &slot = thread->slots[position & thread->mask];
+                const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+                if (sequence != 2 * (position + 1)) {
+                    continue;
+                }
+                const char *category = slot.category.load(std::memory_order_relaxed);
+                const std::string_view name(slot.name.load(std::memory_order_relaxed),
+                                            slot.nameSize.load(std::memory_order_relaxed));
+                const char *argName = slot.argName.load(std::memory_order_relaxed);
+                const int64_t value = slot.value.load(std::memory_order_relaxed);
+                const uint64_t timestamp = slot.timestamp.load(std::memory_order_relaxed);
+                const uint64_t duration = slot.duration.load(std::memory_order_relaxed);
+                const char phase = slot.phase.load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.sequence.load(std::memory_order_relaxed) != sequence || timestamp < clearedAt) {
+                    continue;
+                }
+
+                out << (first ? "" : ",") << "\n{\"ph\":\"" << phase << "\",\"cat\":\"";
+                WriteEscaped(out, category ? category : "hotline");
+                out << "\",\"name\":\"";
+                WriteEscaped(out, name);
+                out << "\",\"pid\":1,\"tid\":" << thread->id << ",\"ts\":";
+                WriteMicroseconds(out, timestamp);
+                if (phase == 'X') {
+                    out << ",\"dur\":";
+                    WriteMicroseconds(out, duration);
+                } else if (phase == 'i') {
+                    out << ",\"s\":\"t\"";
+                }
+                if (argName) {
+                    out << ",\"args\":{\"";
+                    WriteEscaped(out, argName);
+                    out << "\":" << value << "}";
+                }
+                out << "}";
+                first = false;
+            }
+        }
+        out << "\n]}\n";
+    }
+
+    bool TraceRecorder::WriteJson(const std::string &path) const {
+        std::ofstream file(path, std::ios::binary);
+        if (!file) {
+            return false;
+        }
+        WriteJson(file);
+        return static_cast<bool>(file);
+    }
+
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "search/StringPool.h"
+
+namespace hotline {
+
+    // records palette sessions as Chrome trace events (chrome://tracing, ui.perfetto.dev): keystrokes, searches,
+    // frontend draws, provider states and executed actions. Every thread writes to its own ring buffer without
+    // locks, so recording can stay enabled. Only latest events of each thread are kept.
+    // Names, categories and argument names are not copied: they have to be literals or go through Intern.
+    // Built with HOTLINE_TRACE, HOTLINE_TRACE_* macros compile to nothing without it
+    class TraceRecorder {
+    public:
+        static TraceRecorder &Get();
+
+        void SetEnabled(bool enabled) { _enabled.store(enabled, std::memory_order_relaxed); }
+        bool IsEnabled() const { return _enabled.load(std::memory_order_relaxed); }
+
+        // events kept per thread, rounded up to power of two. Applies to threads which record first time later
+        void SetThreadCapacity(size_t events);
+        // shown as track name, literal
+        void SetThreadName(const char *name);
+
+        // nanoseconds since recorder creation
+        uint64_t Now() const;
+
+        // copy of name which may not outlive the trace (action names), kept until exit. Only while enabled
+        std::string_view Intern(std::string_view name) { return IsEnabled() ? _names.Intern(name) : name; }
+
+        void Complete(const char *category, std::string_view name, uint64_t start, uint64_t end,
+                      const char *argName = nullptr, int64_t value = 0);
+        void Instant(const char *category, std::string_view name, const char *argName = nullptr, int64_t value = 0);
+        void Counter(const char *category, std::string_view name, int64_t value);
+
+        // events recorded before are not written anymore
+        void Clear();
+
+        // may be called while other threads record, events overwritten during reading are skipped
+        void WriteJson(std::ostream &out) const;
+        bool WriteJson(const std::string &path) const;
+
+    private:
+        // fields are atomics, so reading a slot being overwritten is a detectable miss, not a data race
+        struct Slot {
+            std::atomic<uint64_t> sequence{0};  // odd while written, 2 * (position + 1) when done
+            std::atomic<const char *> category{nullptr};
+            std::atomic<const char *> name{nullptr};
+            std::atomic<size_t> nameSize{0};
+            std::atomic<const char *> argName{nullptr};
+            std::atomic<int64_t> value{0};
+            std::atomic<uint64_t> timestamp{0};
+            std::atomic<uint64_t> duration{0};
+            std::atomic<char> phase{0};
+        };
+
+        struct ThreadBuffer {
+            ThreadBuffer(size_t capacity, int id);
+
+            std::unique_ptr<Slot[]> slots;
+            size_t mask;
+            std::atomic<uint64_t> head{0};  // written by owning thread only
+            std::atomic<const char *> name{nullptr};
+            int id;
+        };
+
+        TraceRecorder();
+
+        ThreadBuffer &GetThreadBuffer();
+        void Record(char phase, const char *category, std::string_view name, uint64_t timestamp, uint64_t duration,
+                    const char *argName, int64_t value);
+
+        std::atomic<bool> _enabled{false};
+        std::atomic<uint64_t> _clearedAt{0};
+        size_t _threadCapacity = 16 * 1024;
+        const std::chrono::steady_clock::time_point _epoch;
+        StringPool _names;  // never released
+        // threads register once, buffers outlive their threads so late events can still be written
+        mutable std::mutex _threadsMutex;
+        std::vector<std::shared_ptr<ThreadBuffer>> _threads;
+    };
+
+    // complete event from construction to destruction, with one optional argument
+    class TraceSpan {
+    public:
+        TraceSpan(const char *category, std::string_view name)
+                : _active(TraceRecorder::Get().IsEnabled()), _category(category), _name(name),
+                  _start(_active ? TraceRecorder::Get().Now() : 0) {}
+
+        ~TraceSpan() {
+            if (_active) {
+                TraceRecorder &recorder = TraceRecorder::Get();
+                recorder.Complete(_category, _name, _start, recorder.Now(), _argName, _value);
+            }
+        }
+
+        TraceSpan(const TraceSpan &) = delete;
+        TraceSpan &operator=(const TraceSpan &) = delete;
+
+        void SetArg(const char *argName, int64_t value) {
+            _argName = argName;
+            _value = value;
+        }
+
+    private:
+        bool _active;
+        const char *_category;
+        std::string_view _name;
+        uint64_t _start;
+        const char *_argName = nullptr;
+        int64_t _value = 0;
+    };
+
+}
+
+#if defined(HOTLINE_TRACE)
+#define HOTLINE_TRACE_CONCAT_IMPL(a, b) a##b
+#define HOTLINE_TRACE_CONCAT(a, b) HOTLINE_TRACE_CONCAT_IMPL(a, b)
+#define HOTLINE_TRACE_SCOPE(category, name) \
+    hotline::TraceSpan HOTLINE_TRACE_CONCAT(hotlineTraceSpan, __LINE__)(category, name)
+#define HOTLINE_TRACE_SPAN(var, category, name) hotline::TraceSpan var(category, name)
+#define HOTLINE_TRACE_SPAN_ARG(var, argName, value) var.SetArg(argName, static_cast<int64_t>(value))
+#define HOTLINE_TRACE_INSTANT(category, name, argName, value) \
+    hotline::TraceRecorder::Get().Instant(category, name, argName, static_cast<int64_t>(value))
+#define HOTLINE_TRACE_COUNTER(category, name, value) \
+    hotline::TraceRecorder::Get().Counter(category, name, static_cast<int64_t>(value))
+#define HOTLINE_TRACE_THREAD_NAME(name) hotline::TraceRecorder::Get().SetThreadName(name)
+#else
+#define HOTLINE_TRACE_SCOPE(category, name) ((void)0)
+#define HOTLINE_TRACE_SPAN(var, category, name) ((void)0)
+#define HOTLINE_TRACE_SPAN_ARG(var, argName, value) ((void)0)
+#define HOTLINE_TRACE_INSTANT(category, name, argName, value) ((void)0)
+#define HOTLINE_TRACE_COUNTER(category, name, value) ((void)0)
+#define HOTLINE_TRACE_THREAD_NAME(name) ((void)0)
+#endif
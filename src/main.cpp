@@ -13,6 +13,7 @@
 #include <GLES2/gl2.h>
 #endif
 
+#include <filesystem>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -23,6 +24,7 @@
 #include "ActionSet.h"
 #include "Hotline.h"
 #include "ArgProvider.h"
+#include "TraceRecorder.h"
 
 // [Win32] Our example includes a copy of glfw3.lib pre-compiled with VS2010 to maximize ease of testing and compatibility with old VS compilers.
 // To link with VS2010-era libraries, VS2015+ requires linking with legacy_stdio_definitions.lib, which we do using this pragma.
@@ -58,6 +60,18 @@ void testFunctionThreePar(const std::string &param1, int param2, bool param3) {
     infoMessages.push_back("executed 3 param: " + param1 + " " + std::to_string(param2) + " " + std::to_string(param3));
 }
 
+void testFunctionAsset(const std::string &asset) {
+    infoMessages.push_back("executed asset param: " + asset);
+}
+
+static std::vector<std::string> generateAssetNames() {
+    std::vector<std::string> names;
+    names.reserve(100000);
+    for (int i = 0; i < 100000; i++) {
+        names.push_back("Assets/Meshes/Mesh_" + std::to_string(i));
+    }
+    return names;
+}
 
 // Main code
 int main(int, char **) {
@@ -119,10 +133,41 @@ int main(int, char **) {
                          ArgProvider<std::string>("Name"),
                          ArgProvider<int>("Level"),
                          ArgProvider<bool>("IsActive"));
+    actionSet->AddAction("SpawnAsset", testFunctionAsset,
+                         StringSearchArgProvider("Asset", generateAssetNames));
+
+    //  lazily provided actions: directory is listed on first search, not at startup
+    actionSet->AddSource(std::make_shared<hotline::CachedActionSource>(
+            [](std::vector<std::string> &names) {
+                for (const auto &entry: std::filesystem::directory_iterator(".")) {
+                    names.push_back("Open:" + entry.path().filename().string());
+                }
+            },
+            [](const std::string &name, const std::vector<std::string> &) {
+                infoMessages.push_back("executed source action: " + name);
+            }));
+
+    //  typed exactly, alias is ranked first and executed without fuzzy search
+    actionSet->AddActionAlias("ThreeParFunction", "tpf3");
+
+    //  "tgogle" still finds "ToggleX" etc, typo matches are listed after exact ones
+    actionSet->SetTypoTolerance(2);
+
+    //  "@test #args par" lists only test functions with arguments
+    for (const auto *name: {"ZeroParFunction", "OneParFunction", "TwoParFunction", "ThreeParFunction"}) {
+        actionSet->SetActionCategory(name, "test");
+    }
+    for (const auto *name: {"OneParFunction", "TwoParFunction", "ThreeParFunction", "SpawnAsset"}) {
+        actionSet->AddActionTag(name, "args");
+    }
 
     //  instantiation of hotline
 	Hotline::hotlineConfig.scaleFactor = scaleFactor;
     Hotline::hotlineConfig.showRecentActions = true;
+#ifdef __EMSCRIPTEN__
+    //  no threads to search in background, big searches are spread over frames instead
+    Hotline::hotlineConfig.searchTimeBudgetUs = 4000;
+#endif
     // you can modify config as you like here
     auto hotline = std::make_unique<Hotline::Hotline>();
 
@@ -130,6 +175,20 @@ int main(int, char **) {
 
     manager->AddFrontend("hotline", std::move(hotline));
 
+#ifdef HOTLINE_COMMAND_SERVER
+    //  printf 'ToggleX\nOneParFunction 5\n' | hotline_command_client /tmp/hotline.sock
+    manager->StartCommandServer("/tmp/hotline.sock");
+#endif
+
+#ifdef HOTLINE_TRACE
+    //  "SaveTrace" writes recent palette activity, open it in ui.perfetto.dev
+    Hotline::TraceRecorder::Get().SetEnabled(true);
+    Hotline::TraceRecorder::Get().SetThreadName("ui");
+    actionSet->AddAction("SaveTrace", []() {
+        Hotline::TraceRecorder::Get().WriteJson(std::string("hotline_trace.json"));
+    });
+#endif
+
 
     // Main loop
 #ifdef __EMSCRIPTEN__
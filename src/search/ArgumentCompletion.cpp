@@ -0,0 +1,124 @@
+#include "ArgumentCompletion.h"
+
+#include <algorithm>
+
+#include "Utf8.h"
+
+namespace hotline {
+    namespace {
+        bool StartsWithLower(std::string_view lowerValue, std::string_view lowerPrefix) {
+            return lowerValue.substr(0, lowerPrefix.size()) == lowerPrefix;
+        }
+    }
+
+    void PrefixIndex::Build(const std::vector<std::string> &values) {
+        _entries.resize(values.size());
+        for (size_t i = 0; i < values.size(); i++) {
+            _entries[i].value = values[i];
+            ToLower(values[i], _entries[i].lowerValue);
+        }
+        std::sort(_entries.begin(), _entries.end(), [](const Entry &a, const Entry &b) {
+            return a.lowerValue != b.lowerValue ? a.lowerValue < b.lowerValue : a.value < b.value;
+        });
+    }
+
+    std::pair<const PrefixIndex::Entry *, const PrefixIndex::Entry *>
+    PrefixIndex::FindPrefix(std::string_view lowerPrefix) const {
+        const Entry *begin = _entries.data();
+        const Entry *end = begin + _entries.size();
+        const Entry *first = std::lower_bound(begin, end, lowerPrefix, [](const Entry &entry, std::string_view prefix) {
+            return std::string_view(entry.lowerValue) < prefix;
+        });
+        const Entry *last = std::partition_point(first, end, [&](const Entry &entry) {
+            return StartsWithLower(entry.lowerValue, lowerPrefix);
+        });
+        return {first, last};
+    }
+
+    ArgumentCompletionIndex::ArgumentCompletionIndex(size_t valuesPerArgument)
+            : _valuesPerArgument(valuesPerArgument) {}
+
+    void ArgumentCompletionIndex::Record(const std::string &actionName, const std::vector<std::string> &args) {
+        if (args.empty()) {
+            return;
+        }
+
+        auto &perArgument = _entries[actionName];
+        if (perArgument.size() < args.size()) {
+            perArgument.resize(args.size());
+        }
+
+        for (size_t argIdx = 0; argIdx < args.size(); argIdx++) {
+            if (args[argIdx].empty()) {
+                continue;
+            }
+            auto &values = perArgument[argIdx];
+            _clock++;
+            auto found = std::find_if(values.begin(), values.end(),
+                                      [&](const Entry &entry) { return entry.value == args[argIdx]; });
+            if (found != values.end()) {
+                found->uses++;
+                found->lastUse = _clock;
+                continue;
+            }
+
+            Entry entry;
+            entry.value = args[argIdx];
+            entry.lowerValue = ToLower(args[argIdx]);
+            entry.uses = 1;
+            entry.lastUse = _clock;
+            if (values.size() < _valuesPerArgument) {
+                values.push_back(std::move(entry));
+            } else {
+                auto leastRecent = std::min_element(values.begin(), values.end(),
+                                                    [](const Entry &a, const Entry &b) { return a.lastUse < b.lastUse; });
+                *leastRecent = std::move(entry);
+            }
+        }
+    }
+
+    void ArgumentCompletionIndex::Complete(const std::string &actionName, size_t argIdx, const std::string &prefix,
+                                           const PrefixIndex *presets, size_t limit,
+                                           std::vector<std::string> &out) const {
+        out.clear();
+        if (limit == 0) {
+            return;
+        }
+
+        const std::string lowerPrefix = ToLower(prefix);
+
+        if (auto found = _entries.find(actionName); found != _entries.end() && argIdx < found->second.size()) {
+            const auto &values = found->second[argIdx];
+            std::vector<const Entry *> matched;
+            for (const auto &entry: values) {
+                if (StartsWithLower(entry.lowerValue, lowerPrefix)) {
+                    matched.push_back(&entry);
+                }
+            }
+            std::sort(matched.begin(), matched.end(), [](const Entry *a, const Entry *b) {
+                return a->uses != b->uses ? a->uses > b->uses : a->lastUse > b->lastUse;
+            });
+            for (size_t i = 0; i < matched.size() && out.size() < limit; i++) {
+                out.push_back(matched[i]->value);
+            }
+        }
+
+        const size_t historyCount = out.size();
+        if (!presets) {
+            return;
+        }
+        // range is never walked further than limit plus values already taken from history
+        const auto [first, last] = presets->FindPrefix(lowerPrefix);
+        for (auto entry = first; entry != last && out.size() < limit; ++entry) {
+            if (std::find(out.begin(), out.begin() + historyCount, entry->value) == out.begin() + historyCount) {
+                out.push_back(entry->value);
+            }
+        }
+    }
+
+    void ArgumentCompletionIndex::Clear() {
+        _entries.clear();
+        _clock = 0;
+    }
+
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace hotline {
+
+    // known values of an argument sorted by lowercase form, values starting with a prefix are one range
+    // found by binary search. Built by providers once per change of their values
+    class PrefixIndex {
+    public:
+        struct Entry {
+            std::string lowerValue;
+            std::string value;
+        };
+
+        void Build(const std::vector<std::string> &values);
+        void Clear() { _entries.clear(); }
+        bool IsEmpty() const { return _entries.empty(); }
+
+        // entries whose lowercase form starts with lowerPrefix, alphabetically, so exact value goes first
+        std::pair<const Entry *, const Entry *> FindPrefix(std::string_view lowerPrefix) const;
+
+    private:
+        std::vector<Entry> _entries;
+    };
+
+    // remembers argument values used per (action, argument) and completes partially typed ones
+    class ArgumentCompletionIndex {
+    public:
+        explicit ArgumentCompletionIndex(size_t valuesPerArgument = 16);
+
+        void Record(const std::string &actionName, const std::vector<std::string> &args);
+
+        // previously used values first (most used, then most recent), then known values of provider
+        // alphabetically, all filtered by case-insensitive prefix. presets may be null
+        void Complete(const std::string &actionName, size_t argIdx, const std::string &prefix,
+                      const PrefixIndex *presets, size_t limit, std::vector<std::string> &out) const;
+
+        void Clear();
+
+    private:
+        struct Entry {
+            std::string value;
+            std::string lowerValue;
+            uint32_t uses = 0;
+            uint64_t lastUse = 0;
+        };
+
+        size_t _valuesPerArgument;
+        uint64_t _clock = 0;
+        std::unordered_map<std::string, std::vector<std::vector<Entry>>> _entries;  // action -> argument -> values
+    };
+
+}
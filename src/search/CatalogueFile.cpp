@@ -0,0 +1,212 @@
+#include "CatalogueFile.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <unordered_set>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "FuzzyScorer.h"
+#include "Utf8.h"
+
+namespace hotline {
+
+    namespace {
+        constexpr char catalogueMagic[8] = {'H', 'L', 'C', 'A', 'T', 'L', 'G', '\0'};
+
+        uint64_t AlignUp(uint64_t value) {
+            return (value + 7) & ~uint64_t(7);
+        }
+    }
+
+    bool WriteCatalogue(const std::string &path, const std::vector<std::string_view> &names) {
+        std::vector<CatalogueEntry> entries;
+        std::vector<std::string_view> entryNames;
+        std::string strings;
+        std::string lower;
+        std::unordered_set<std::string_view> written;
+        entries.reserve(names.size());
+        entryNames.reserve(names.size());
+        written.reserve(names.size());
+        for (const auto name: names) {
+            if (!written.insert(name).second) {
+                continue;
+            }
+            ToLower(name, lower);
+            CatalogueEntry entry{};
+            entry.mask = FuzzyScorer::ComputeCharMask(lower);
+            entry.nameOffset = static_cast<uint32_t>(strings.size());
+            entry.nameSize = static_cast<uint32_t>(name.size());
+            strings.append(name);
+            if (lower == name) {
+                entry.lowerOffset = entry.nameOffset;
+            } else {
+                entry.lowerOffset = static_cast<uint32_t>(strings.size());
+                strings.append(lower);
+            }
+            entry.lowerSize = static_cast<uint32_t>(lower.size());
+            if (strings.size() > UINT32_MAX) {
+                return false;
+            }
+            entries.push_back(entry);
+            entryNames.push_back(name);
+        }
+
+        std::vector<uint32_t> sorted(entries.size());
+        for (size_t i = 0; i < sorted.size(); i++) {
+            sorted[i] = static_cast<uint32_t>(i);
+        }
+        std::sort(sorted.begin(), sorted.end(), [&](uint32_t a, uint32_t b) { return entryNames[a] < entryNames[b]; });
+
+        CatalogueHeader header{};
+        std::memcpy(header.magic, catalogueMagic, sizeof(header.magic));
+        header.formatVersion = catalogueFormatVersion;
+        header.entryCount = static_cast<uint32_t>(entries.size());
+        header.entriesOffset = AlignUp(sizeof(CatalogueHeader));
+        header.sortedOffset = AlignUp(header.entriesOffset + entries.size() * sizeof(CatalogueEntry));
+        header.stringsOffset = AlignUp(header.sortedOffset + sorted.size() * sizeof(uint32_t));
+        header.stringsSize = strings.size();
+        header.fileSize = header.stringsOffset + header.stringsSize;
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            return false;
+        }
+        auto writeAt = [&file](uint64_t offset, const void *data, size_t size) {
+            // zero padding up to section start
+            static const char padding[8] = {};
+            file.write(padding, static_cast<std::streamsize>(offset - static_cast<uint64_t>(file.tellp())));
+            file.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+        };
+        writeAt(0, &header, sizeof(header));
+        writeAt(header.entriesOffset, entries.data(), entries.size() * sizeof(CatalogueEntry));
+        writeAt(header.sortedOffset, sorted.data(), sorted.size() * sizeof(uint32_t));
+        writeAt(header.stringsOffset, strings.data(), strings.size());
+        return static_cast<bool>(file.flush());
+    }
+
+    MappedCatalogue::~MappedCatalogue() {
+        Close();
+    }
+
+    bool MappedCatalogue::Open(const std::string &path) {
+        Close();
+#if defined(_WIN32)
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+            CloseHandle(file);
+            return false;
+        }
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        const void *data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (!data) {
+            if (mapping) {
+                CloseHandle(mapping);
+            }
+            CloseHandle(file);
+            return false;
+        }
+        _file = file;
+        _mapping = mapping;
+        _data = static_cast<const char *>(data);
+        _size = static_cast<size_t>(size.QuadPart);
+#else
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat info{};
+        if (fstat(fd, &info) != 0 || info.st_size == 0) {
+            close(fd);
+            return false;
+        }
+        void *data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        // mapping stays valid after descriptor is closed
+        close(fd);
+        if (data == MAP_FAILED) {
+            return false;
+        }
+        _data = static_cast<const char *>(data);
+        _size = static_cast<size_t>(info.st_size);
+#endif
+        if (!Validate()) {
+            Close();
+            return false;
+        }
+        return true;
+    }
+
+    void MappedCatalogue::Close() {
+        if (_data) {
+#if defined(_WIN32)
+            UnmapViewOfFile(_data);
+            CloseHandle(_mapping);
+            CloseHandle(_file);
+            _mapping = nullptr;
+            _file = nullptr;
+#else
+            munmap(const_cast<char *>(_data), _size);
+#endif
+        }
+        _data = nullptr;
+        _size = 0;
+        _entries = nullptr;
+        _sorted = nullptr;
+        _strings = nullptr;
+        _stringsSize = 0;
+        _entryCount = 0;
+    }
+
+    bool MappedCatalogue::Validate() {
+        if (_size < sizeof(CatalogueHeader)) {
+            return false;
+        }
+        const auto *header = reinterpret_cast<const CatalogueHeader *>(_data);
+        if (std::memcmp(header->magic, catalogueMagic, sizeof(catalogueMagic)) != 0
+            || header->formatVersion != catalogueFormatVersion || header->fileSize != _size) {
+            return false;
+        }
+        // sections follow each other and end inside file. Sizes are compared to remaining space, so
+        // offsets from a broken file can't overflow
+        auto fits = [](uint64_t offset, uint64_t size, uint64_t end) { return offset <= end && size <= end - offset; };
+        const uint64_t count = header->entryCount;
+        if (header->entriesOffset % 8 != 0 || header->sortedOffset % 8 != 0
+            || header->entriesOffset < sizeof(CatalogueHeader)
+            || !fits(header->entriesOffset, count * sizeof(CatalogueEntry), header->sortedOffset)
+            || !fits(header->sortedOffset, count * sizeof(uint32_t), header->stringsOffset)
+            || !fits(header->stringsOffset, header->stringsSize, _size)) {
+            return false;
+        }
+        _entries = reinterpret_cast<const CatalogueEntry *>(_data + header->entriesOffset);
+        _sorted = reinterpret_cast<const uint32_t *>(_data + header->sortedOffset);
+        _strings = _data + header->stringsOffset;
+        _stringsSize = header->stringsSize;
+        _entryCount = static_cast<size_t>(count);
+        return true;
+    }
+
+    size_t MappedCatalogue::Find(std::string_view name) const {
+        const uint32_t *end = _sorted + _entryCount;
+        auto nameAt = [this](uint32_t idx) { return idx < _entryCount ? GetName(idx) : std::string_view(); };
+        const uint32_t *found = std::lower_bound(_sorted, end, name, [&nameAt](uint32_t idx, std::string_view value) {
+            return nameAt(idx) < value;
+        });
+        return found != end && *found < _entryCount && IsValid(*found) && GetName(*found) == name ? *found : npos;
+    }
+
+}
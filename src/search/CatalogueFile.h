@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace hotline {
+
+    // prebuilt catalogue: names with derived search data, laid out to be searched in place from a read-only
+    // mapping without parsing. Sections follow header, 8-byte aligned, offsets are from file start and
+    // values are in host byte order:
+    //   CatalogueEntry[entryCount]
+    //   uint32_t[entryCount]      entry indexes sorted by name bytes, for exact lookup
+    //   char[stringsSize]         names and lowercase names, not terminated
+    struct CatalogueHeader {
+        char magic[8];
+        uint32_t formatVersion;
+        uint32_t entryCount;
+        uint64_t fileSize;
+        uint64_t entriesOffset;
+        uint64_t sortedOffset;
+        uint64_t stringsOffset;
+        uint64_t stringsSize;
+    };
+
+    struct CatalogueEntry {
+        uint64_t mask;              // FuzzyScorer::ComputeCharMask of lowercase name
+        uint32_t nameOffset;        // into strings
+        uint32_t lowerOffset;       // same as nameOffset when name is lowercase already
+        uint32_t nameSize;
+        uint32_t lowerSize;
+    };
+
+    // files of other version are rejected by MappedCatalogue::Open, they have to be written again
+    constexpr uint32_t catalogueFormatVersion = 1;
+
+    // duplicate names are written once. False if file can't be written or strings exceed 4 GB
+    bool WriteCatalogue(const std::string &path, const std::vector<std::string_view> &names);
+
+    // read-only mapping of catalogue file. Open checks header and section bounds only, so it takes the
+    // same time for any size. Entries and index values are checked when read, strings are read in place
+    class MappedCatalogue {
+    public:
+        static constexpr size_t npos = ~size_t(0);
+
+        MappedCatalogue() = default;
+        ~MappedCatalogue();
+
+        MappedCatalogue(const MappedCatalogue &) = delete;
+        MappedCatalogue &operator=(const MappedCatalogue &) = delete;
+
+        // false if file is missing, of other format version, truncated or has offsets out of bounds
+        bool Open(const std::string &path);
+        void Close();
+        bool IsOpen() const { return _data != nullptr; }
+
+        size_t Size() const { return _entryCount; }
+        // strings of entry end inside strings section. Checked on read, so Open doesn't walk all entries
+        bool IsValid(size_t idx) const {
+            const CatalogueEntry &entry = _entries[idx];
+            return uint64_t(entry.nameOffset) + entry.nameSize <= _stringsSize
+                   && uint64_t(entry.lowerOffset) + entry.lowerSize <= _stringsSize;
+        }
+        // empty for broken entries
+        std::string_view GetName(size_t idx) const {
+            return IsValid(idx) ? std::string_view(_strings + _entries[idx].nameOffset, _entries[idx].nameSize)
+                                : std::string_view();
+        }
+        std::string_view GetLowerName(size_t idx) const {
+            return IsValid(idx) ? std::string_view(_strings + _entries[idx].lowerOffset, _entries[idx].lowerSize)
+                                : std::string_view();
+        }
+        uint64_t GetMask(size_t idx) const { return _entries[idx].mask; }
+
+        // entry with exactly this name, npos if none. Binary search over sorted section, index values out
+        // of range are skipped
+        size_t Find(std::string_view name) const;
+
+    private:
+        bool Validate();
+
+        const char *_data = nullptr;
+        size_t _size = 0;
+        const CatalogueEntry *_entries = nullptr;
+        const uint32_t *_sorted = nullptr;
+        const char *_strings = nullptr;
+        uint64_t _stringsSize = 0;
+        size_t _entryCount = 0;
+#if defined(_WIN32)
+        void *_file = nullptr;
+        void *_mapping = nullptr;
+#endif
+    };
+
+}
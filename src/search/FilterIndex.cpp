@@ -0,0 +1,34 @@
+#include "FilterIndex.h"
+
+namespace hotline {
+
+    std::string FilterIndex::MakeCategoryKey(std::string_view category) {
+        return "@" + SearchIndex::Normalize(category);
+    }
+
+    std::string FilterIndex::MakeTagKey(std::string_view tag) {
+        return "#" + SearchIndex::Normalize(tag);
+    }
+
+    void FilterIndex::Set(const std::string &key, SearchIndex::Slot slot, bool value) {
+        auto &bitmap = _bitmaps[key];
+        if (slot / 64 >= bitmap.size()) {
+            if (!value) {
+                return;
+            }
+            bitmap.resize(slot / 64 + 1, 0);
+        }
+        const uint64_t bit = uint64_t(1) << (slot % 64);
+        if (value) {
+            bitmap[slot / 64] |= bit;
+        } else {
+            bitmap[slot / 64] &= ~bit;
+        }
+    }
+
+    const FilterIndex::Bitmap *FilterIndex::Find(const std::string &key) const {
+        auto found = _bitmaps.find(key);
+        return found != _bitmaps.end() ? &found->second : nullptr;
+    }
+
+}
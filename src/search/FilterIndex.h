@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "SearchIndex.h"
+
+namespace hotline {
+
+    // bitmap of slots per filter key ("@category", "#tag"). Query filters are resolved to bitmaps
+    // and intersected with available slots before any name is scored
+    class FilterIndex {
+    public:
+        using Bitmap = std::pmr::vector<uint64_t>;
+
+        explicit FilterIndex(std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+                : _bitmaps(resource) {}
+
+        // filter key of category or tag, normalized like names
+        static std::string MakeCategoryKey(std::string_view category);
+        static std::string MakeTagKey(std::string_view tag);
+
+        void Set(const std::string &key, SearchIndex::Slot slot, bool value);
+
+        // null for keys no slot ever had. Bitmap may be shorter than slot count, missing words are zero
+        const Bitmap *Find(const std::string &key) const;
+
+    private:
+        std::pmr::unordered_map<std::string, Bitmap> _bitmaps;
+    };
+
+}
@@ -1,114 +1,102 @@
 #include "FuzzyScorer.h"
+#include "FuzzyScorerImpl.h"
+#include "Utf8.h"
 
 #include <string>
+#include <string_view>
 
 namespace hotline {
 
-    FuzzyScore FuzzyScorer::GetFuzzyScore(const std::string &query, const std::string &queryLower, int querySize,
-                                          const std::string &target, const std::string &targetLower, int targetSize) {
-        if (querySize > targetSize) {
-            return {};
-        }
-
-        std::vector<int> scores(querySize * targetSize, 0);
-        std::vector<int> matches(querySize * targetSize, 0);
-
-        for (int queryIndex = 0; queryIndex < querySize; queryIndex++) {
-            const int queryIndexOffset = queryIndex * targetSize;
-            const int queryIndexPreviousOffset = queryIndexOffset - targetSize;
-
-            const bool queryIndexGtNull = queryIndex > 0;
-
-            const char queryCharAtIndex = query[queryIndex];
-            const char queryLowerCharAtIndex = queryLower[queryIndex];
-
-            for (int targetIndex = 0; targetIndex < targetSize; targetIndex++) {
-                const bool targetIndexGtNull = targetIndex > 0;
-
-                const int currentIndex = queryIndexOffset + targetIndex;
-                const int leftIndex = currentIndex - 1;
-                const int diagIndex = queryIndexPreviousOffset + targetIndex - 1;
-
-                const int leftScore = targetIndexGtNull ? scores[leftIndex] : 0;
-                const int diagScore = queryIndexGtNull && targetIndexGtNull ? scores[diagIndex] : 0;
-
-                const int matchesSequenceLength = queryIndexGtNull && targetIndexGtNull ? matches[diagIndex] : 0;
-
-                const char targetChar = target[targetIndex];
-                const char targetLowerChar = targetLower[targetIndex];
+    FuzzyScore IFuzzyScorer::GetFuzzyScore(std::string_view query, std::string_view queryLower, int querySize,
+                                           std::string_view target, std::string_view targetLower, int targetSize) {
+        return GetFuzzyScore(query, queryLower, querySize, target, targetLower, targetSize,
+                             IsAscii(query) && IsAscii(target));
+    }
 
-                int score;
-                if (!diagScore && queryIndexGtNull) {
-                    score = 0;
-                } else {
-                    score = ComputeCharScore(queryCharAtIndex, queryLowerCharAtIndex, targetChar, targetLowerChar,
-                                             targetIndex, matchesSequenceLength);
-                }
+    int IFuzzyScorer::GetScore(std::string_view query, std::string_view queryLower, int querySize,
+                               std::string_view target, std::string_view targetLower, int targetSize) {
+        return GetScore(query, queryLower, querySize, target, targetLower, targetSize,
+                        IsAscii(query) && IsAscii(target));
+    }
 
-                const bool isValidScore = score && diagScore + score >= leftScore;
-                if (isValidScore) {
-                    matches[currentIndex] = matchesSequenceLength + 1;
-                    scores[currentIndex] = diagScore + score;
-                } else {
-                    matches[currentIndex] = -1;
-                    scores[currentIndex] = leftScore;
-                }
+    uint64_t FuzzyScorerBase::ComputeCharMask(std::string_view lower) {
+        uint64_t mask = 0;
+        for (const char c: lower) {
+            const auto uc = static_cast<unsigned char>(c);
+            int bit;
+            if (uc >= 'a' && uc <= 'z') {
+                bit = uc - 'a';
+            } else if (uc >= '0' && uc <= '9') {
+                bit = 26 + (uc - '0');
+            } else {
+                bit = 36 + (uc % 28);
             }
+            mask |= uint64_t(1) << bit;
         }
+        return mask;
+    }
 
-        // find the path from bottom right
-        std::vector<int> positions;
-        int queryIndex = querySize - 1;
-        int targetIndex = targetSize - 1;
-        while (queryIndex >= 0 && targetIndex >= 0) {
-            const int currentIndex = queryIndex * targetSize + targetIndex;
-            const int match = matches[currentIndex];
-            if (match == -1) {
-                targetIndex--;
-            } else {
-                positions.push_back(targetIndex);
-
-                queryIndex--;
-                targetIndex--;
+    bool FuzzyScorerBase::IsSubsequence(std::string_view queryLower, std::string_view targetLower) {
+        size_t queryIndex = 0;
+        for (size_t targetIndex = 0; targetIndex < targetLower.size() && queryIndex < queryLower.size(); targetIndex++) {
+            if (queryLower[queryIndex] == targetLower[targetIndex]) {
+                queryIndex++;
             }
         }
-
-        std::reverse(positions.begin(), positions.end());
-        return {scores[querySize * targetSize - 1], positions};
+        return queryIndex == queryLower.size();
     }
 
-    int FuzzyScorer::ComputeCharScore(const char &queryChar, const char &queryCharLower, const char &targetChar,
-                                      const char &targetCharLower, int targetIdx, int sequenceMatch) {
-        int score = 0;
-
-        if (queryCharLower != targetCharLower) {
-            return score;
+    namespace {
+        bool IsWordSeparator(unsigned char c) {
+            return c == ' ' || c == '_' || c == '-' || c == '/' || c == '.' || c == ':';
         }
 
-        // Character match bonus
-        score += 1;
-
-        // Sequence match bonus
-        if (sequenceMatch > 0) {
-            score += (sequenceMatch * 5);
-        }
+        bool IsUpperAscii(unsigned char c) { return c >= 'A' && c <= 'Z'; }
+        bool IsLowerAscii(unsigned char c) { return c >= 'a' && c <= 'z'; }
+        bool IsDigitAscii(unsigned char c) { return c >= '0' && c <= '9'; }
+    }
 
-        // Same case bonus
-        if (queryChar == targetChar) {
-            score += 1;
+    void FuzzyScorerBase::ComputeWordStarts(std::string_view name, std::vector<uint64_t> &wordStarts) {
+        wordStarts.assign(name.size() / 64 + 1, 0);
+        for (size_t i = 0; i < name.size(); i++) {
+            const auto c = static_cast<unsigned char>(name[i]);
+            if (IsWordSeparator(c) || (c & 0xC0) == 0x80) {
+                continue;
+            }
+            bool isStart;
+            if (i == 0) {
+                isStart = true;
+            } else {
+                const auto prev = static_cast<unsigned char>(name[i - 1]);
+                const auto next = i + 1 < name.size() ? static_cast<unsigned char>(name[i + 1]) : 0;
+                isStart = IsWordSeparator(prev)
+                          || (IsUpperAscii(c) && !IsUpperAscii(prev))
+                          || (IsUpperAscii(c) && IsLowerAscii(next))
+                          || (IsDigitAscii(c) != IsDigitAscii(prev));
+            }
+            if (isStart) {
+                wordStarts[i / 64] |= uint64_t(1) << (i % 64);
+            }
         }
+    }
 
-        // Start of word bonus
-        if (targetIdx == 0) {
-            score += 8;
+    std::string FuzzyScorerBase::ComputeAcronym(std::string_view name, const std::vector<uint64_t> &wordStarts) {
+        std::string acronym;
+        int words = 0;
+        for (size_t i = 0; i < name.size(); i = NextCodePoint(name, i)) {
+            if (IsWordStart(wordStarts.data(), static_cast<int>(i))) {
+                acronym += ToLower(name.substr(i, NextCodePoint(name, i) - i));
+                words++;
+            }
         }
-
-        // Bonus for uppercase
-        if (targetChar != targetCharLower) {
-            score += 2;
+        // single word names are served by regular matching
+        if (words < 2) {
+            acronym.clear();
         }
-
-        return score;
+        return acronym;
     }
 
-}
\ No newline at end of file
+    template class BasicFuzzyScorer<DefaultScoringPolicy>;
+    template class BasicFuzzyScorer<RuntimeScoringPolicy>;
+
+}
@@ -1,24 +1,188 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 #include <string>
+#include <string_view>
 
 namespace hotline {
 
+    // in rank order, better kinds go first regardless of score
+    enum class MatchKind : uint8_t {
+        Exact,          // query is normalized name or alias, see SearchIndex::FindExact
+        Acronym,        // query is acronym of name words, e.g. tpf for ThreeParFunction
+        Subsequence,
+        Typo,           // see TypoMatcher
+    };
+
     struct FuzzyScore {
         int score = 0;
         std::vector<int> positions;
+        MatchKind kind = MatchKind::Subsequence;
+        int typos = 0;      // edits needed for typo-tolerant match, 0 for exact subsequence match
+    };
+
+    // by match kind, typo matches by number of edits, then by score
+    inline bool IsBetterFuzzyScore(const FuzzyScore &a, const FuzzyScore &b) {
+        if (a.kind != b.kind) {
+            return a.kind < b.kind;
+        }
+        return a.typos != b.typos ? a.typos < b.typos : a.score > b.score;
+    }
+
+    // bonus points of ComputeCharScore
+    struct ScoringWeights {
+        int charMatch = 1;
+        int sequence = 5;       // per character already matched in a row
+        int sameCase = 1;
+        int nameStart = 8;
+        int wordStart = 4;      // see FuzzyScorerBase::ComputeWordStarts
+    };
+
+    // scoring policies give weights to BasicFuzzyScorer. Weights of compile time policies are constants,
+    // so scorer kernel is specialized for them and features with zero weight are compiled out:
+    //     struct CommandScoring {
+    //         static constexpr bool runtimeWeights = false;
+    //         static constexpr ScoringWeights weights{1, 8, 0, 10, 6};
+    //     };
+    struct DefaultScoringPolicy {
+        static constexpr bool runtimeWeights = false;
+        static constexpr ScoringWeights weights{};
+    };
+
+    // weights can be changed between searches, for ranking experiments
+    struct RuntimeScoringPolicy {
+        static constexpr bool runtimeWeights = true;
+        ScoringWeights weights;
+    };
+
+    // policy independent helpers, computed once per name at registration
+    class FuzzyScorerBase {
+    public:
+        // prefilter: bit set of characters present in string, query can match only if its mask is covered
+        static uint64_t ComputeCharMask(std::string_view lower);
+
+        static bool IsMaskCovered(uint64_t queryMask, uint64_t targetMask) {
+            return (queryMask & targetMask) == queryMask;
+        }
+
+        static bool IsSubsequence(std::string_view queryLower, std::string_view targetLower);
+
+        // bit per byte of name, set where a word starts: name start, after separator (space _ - / . :),
+        // CamelCase humps (also the last capital of HTMLParser), first digit of a number and
+        // first letter after it
+        static void ComputeWordStarts(std::string_view name, std::vector<uint64_t> &wordStarts);
+
+        static bool IsWordStart(const uint64_t *wordStarts, int byteIdx) {
+            return (wordStarts[byteIdx / 64] >> (byteIdx % 64)) & 1;
+        }
+
+        // lowercase first characters of words, empty for single word names
+        static std::string ComputeAcronym(std::string_view name, const std::vector<uint64_t> &wordStarts);
+    };
+
+    // Text is UTF-8, lowercase forms are expected from hotline::ToLower. Sizes are in bytes and
+    // match positions are byte offsets of matched code points
+    class IFuzzyScorer : public FuzzyScorerBase {
+    public:
+        virtual ~IFuzzyScorer() = default;
+
+        FuzzyScore GetFuzzyScore(std::string_view query, std::string_view queryLower, int querySize,
+                                 std::string_view target, std::string_view targetLower, int targetSize);
+
+        // isAscii: both query and target are known to be ASCII (e.g. detected at registration),
+        // then bytes are compared directly without decoding.
+        // wordStarts: bitmap from ComputeWordStarts of target, computed per call if null
+        virtual FuzzyScore GetFuzzyScore(std::string_view query, std::string_view queryLower, int querySize,
+                                         std::string_view target, std::string_view targetLower, int targetSize,
+                                         bool isAscii, const uint64_t *wordStarts = nullptr) = 0;
+
+        // GetFuzzyScore appending match positions to reused buffer instead of allocating them
+        virtual int AppendFuzzyPositions(std::string_view query, std::string_view queryLower, int querySize,
+                                         std::string_view target, std::string_view targetLower, int targetSize,
+                                         bool isAscii, const uint64_t *wordStarts, std::vector<int> &positions) = 0;
+
+        // same as GetFuzzyScore, but skips match positions backtracking and doesn't allocate
+        int GetScore(std::string_view query, std::string_view queryLower, int querySize,
+                     std::string_view target, std::string_view targetLower, int targetSize);
+
+        virtual int GetScore(std::string_view query, std::string_view queryLower, int querySize,
+                             std::string_view target, std::string_view targetLower, int targetSize, bool isAscii,
+                             const uint64_t *wordStarts = nullptr) = 0;
     };
 
-    class FuzzyScorer {
+    // member definitions are in FuzzyScorerImpl.h. Built-in policies are instantiated in FuzzyScorer.cpp,
+    // for own policy include FuzzyScorerImpl.h in one source file and instantiate it there
+    template<typename Policy>
+    class BasicFuzzyScorer : public IFuzzyScorer {
     public:
-        FuzzyScore GetFuzzyScore(const std::string &query, const std::string &queryLower, int querySize,
-                                 const std::string &target, const std::string &targetLower, int targetSize);
+        BasicFuzzyScorer() = default;
+        explicit BasicFuzzyScorer(const Policy &policy) : _policy(policy) {}
+
+        using IFuzzyScorer::GetFuzzyScore;
+        using IFuzzyScorer::GetScore;
+
+        FuzzyScore GetFuzzyScore(std::string_view query, std::string_view queryLower, int querySize,
+                                 std::string_view target, std::string_view targetLower, int targetSize,
+                                 bool isAscii, const uint64_t *wordStarts = nullptr) override;
+
+        int AppendFuzzyPositions(std::string_view query, std::string_view queryLower, int querySize,
+                                 std::string_view target, std::string_view targetLower, int targetSize,
+                                 bool isAscii, const uint64_t *wordStarts, std::vector<int> &positions) override;
+
+        int GetScore(std::string_view query, std::string_view queryLower, int querySize,
+                     std::string_view target, std::string_view targetLower, int targetSize, bool isAscii,
+                     const uint64_t *wordStarts = nullptr) override;
+
+        Policy &GetPolicy() { return _policy; }
 
     private:
-        int ComputeCharScore(const char &queryChar, const char &queryCharLower,
-                             const char &targetChar, const char &targetCharLower,
-                             int targetIdx, int sequenceMatch);
+        // fills matrices over bytes for ASCII text, over decoded code points otherwise.
+        // Returns false if query is longer than target
+        bool Fill(std::string_view query, std::string_view queryLower, int querySize,
+                  std::string_view target, std::string_view targetLower, int targetSize, bool isAscii,
+                  const uint64_t *wordStarts);
+
+        // targetOffsets maps target units to bytes of wordStarts, null when units are bytes
+        template<typename Text>
+        void FillMatrices(const Text &query, const Text &queryLower, int querySize,
+                          const Text &target, const Text &targetLower, int targetSize,
+                          const uint64_t *wordStarts, const int *targetOffsets);
+
+        int ComputeCharScore(char32_t queryChar, char32_t queryCharLower,
+                             char32_t targetChar, char32_t targetCharLower,
+                             int targetIdx, bool isWordStart, int sequenceMatch) const;
+
+        // bonus may contribute: always for runtime weights, for constant ones if its weight isn't zero
+        static constexpr bool HasBonus(int ScoringWeights::*weight) {
+            if constexpr (Policy::runtimeWeights) {
+                return true;
+            } else {
+                return Policy::weights.*weight != 0;
+            }
+        }
+
+        Policy _policy;
+
+        // reused between calls to avoid allocation per scored candidate
+        std::vector<int> _scores;
+        std::vector<int> _matches;
+        int _querySize = 0;     // in matrix units (bytes or code points) of last Fill
+        int _targetSize = 0;
+
+        // decoded text for non-ASCII path
+        std::u32string _query;
+        std::u32string _queryLower;
+        std::u32string _target;
+        std::u32string _targetLower;
+        std::vector<int> _targetOffsets;    // byte offset of every decoded target code point
+        std::vector<uint64_t> _wordStarts;  // for targets passed without precomputed word starts
     };
 
-}
\ No newline at end of file
+    extern template class BasicFuzzyScorer<DefaultScoringPolicy>;
+    extern template class BasicFuzzyScorer<RuntimeScoringPolicy>;
+
+    using FuzzyScorer = BasicFuzzyScorer<DefaultScoringPolicy>;
+    using RuntimeFuzzyScorer = BasicFuzzyScorer<RuntimeScoringPolicy>;
+
+}
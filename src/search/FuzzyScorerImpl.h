@@ -0,0 +1,190 @@
+#pragma once
+
+// definitions of BasicFuzzyScorer members, see FuzzyScorer.h
+
+#include <algorithm>
+
+#include "FuzzyScorer.h"
+#include "Utf8.h"
+
+namespace hotline {
+
+    template<typename Policy>
+    FuzzyScore BasicFuzzyScorer<Policy>::GetFuzzyScore(std::string_view query, std::string_view queryLower, int querySize,
+                                                       std::string_view target, std::string_view targetLower, int targetSize,
+                                                       bool isAscii, const uint64_t *wordStarts) {
+        FuzzyScore result;
+        result.score = AppendFuzzyPositions(query, queryLower, querySize, target, targetLower, targetSize, isAscii,
+                                            wordStarts, result.positions);
+        return result;
+    }
+
+    template<typename Policy>
+    int BasicFuzzyScorer<Policy>::AppendFuzzyPositions(std::string_view query, std::string_view queryLower, int querySize,
+                                                       std::string_view target, std::string_view targetLower, int targetSize,
+                                                       bool isAscii, const uint64_t *wordStarts,
+                                                       std::vector<int> &positions) {
+        if (!Fill(query, queryLower, querySize, target, targetLower, targetSize, isAscii, wordStarts)) {
+            return 0;
+        }
+
+        // find the path from bottom right
+        const size_t first = positions.size();
+        int queryIndex = _querySize - 1;
+        int targetIndex = _targetSize - 1;
+        while (queryIndex >= 0 && targetIndex >= 0) {
+            const int currentIndex = queryIndex * _targetSize + targetIndex;
+            const int match = _matches[currentIndex];
+            if (match == -1) {
+                targetIndex--;
+            } else {
+                positions.push_back(isAscii ? targetIndex : _targetOffsets[targetIndex]);
+
+                queryIndex--;
+                targetIndex--;
+            }
+        }
+
+        std::reverse(positions.begin() + first, positions.end());
+        return _scores[_querySize * _targetSize - 1];
+    }
+
+    template<typename Policy>
+    int BasicFuzzyScorer<Policy>::GetScore(std::string_view query, std::string_view queryLower, int querySize,
+                                           std::string_view target, std::string_view targetLower, int targetSize, bool isAscii,
+                                           const uint64_t *wordStarts) {
+        if (!Fill(query, queryLower, querySize, target, targetLower, targetSize, isAscii, wordStarts)) {
+            return 0;
+        }
+        return _scores[_querySize * _targetSize - 1];
+    }
+
+    template<typename Policy>
+    bool BasicFuzzyScorer<Policy>::Fill(std::string_view query, std::string_view queryLower, int querySize,
+                                        std::string_view target, std::string_view targetLower, int targetSize, bool isAscii,
+                                        const uint64_t *wordStarts) {
+        if (!wordStarts) {
+            ComputeWordStarts(target.substr(0, targetSize), _wordStarts);
+            wordStarts = _wordStarts.data();
+        }
+
+        if (isAscii) {
+            if (querySize > targetSize || querySize == 0) {
+                return false;
+            }
+            _querySize = querySize;
+            _targetSize = targetSize;
+            FillMatrices(query, queryLower, querySize, target, targetLower, targetSize, wordStarts, nullptr);
+            return true;
+        }
+
+        DecodeUtf8(query.substr(0, querySize), _query, nullptr);
+        DecodeUtf8(queryLower.substr(0, querySize), _queryLower, nullptr);
+        DecodeUtf8(target.substr(0, targetSize), _target, &_targetOffsets);
+        DecodeUtf8(targetLower.substr(0, targetSize), _targetLower, nullptr);
+        // lowercase forms keep code point count, guard against mismatched input anyway
+        _querySize = static_cast<int>(std::min(_query.size(), _queryLower.size()));
+        _targetSize = static_cast<int>(std::min(_target.size(), _targetLower.size()));
+        if (_querySize > _targetSize || _querySize == 0) {
+            return false;
+        }
+        FillMatrices(_query, _queryLower, _querySize, _target, _targetLower, _targetSize, wordStarts,
+                     _targetOffsets.data());
+        return true;
+    }
+
+    template<typename Policy>
+    template<typename Text>
+    void BasicFuzzyScorer<Policy>::FillMatrices(const Text &query, const Text &queryLower, int querySize,
+                                                const Text &target, const Text &targetLower, int targetSize,
+                                                const uint64_t *wordStarts, const int *targetOffsets) {
+        std::vector<int> &scores = _scores;
+        std::vector<int> &matches = _matches;
+        scores.assign(querySize * targetSize, 0);
+        matches.assign(querySize * targetSize, 0);
+
+        for (int queryIndex = 0; queryIndex < querySize; queryIndex++) {
+            const int queryIndexOffset = queryIndex * targetSize;
+            const int queryIndexPreviousOffset = queryIndexOffset - targetSize;
+
+            const bool queryIndexGtNull = queryIndex > 0;
+
+            const auto queryCharAtIndex = query[queryIndex];
+            const auto queryLowerCharAtIndex = queryLower[queryIndex];
+
+            for (int targetIndex = 0; targetIndex < targetSize; targetIndex++) {
+                const bool targetIndexGtNull = targetIndex > 0;
+
+                const int currentIndex = queryIndexOffset + targetIndex;
+                const int leftIndex = currentIndex - 1;
+                const int diagIndex = queryIndexPreviousOffset + targetIndex - 1;
+
+                const int leftScore = targetIndexGtNull ? scores[leftIndex] : 0;
+                const int diagScore = queryIndexGtNull && targetIndexGtNull ? scores[diagIndex] : 0;
+
+                const int matchesSequenceLength = queryIndexGtNull && targetIndexGtNull ? matches[diagIndex] : 0;
+
+                const auto targetChar = target[targetIndex];
+                const auto targetLowerChar = targetLower[targetIndex];
+
+                int score;
+                if (!diagScore && queryIndexGtNull) {
+                    score = 0;
+                } else {
+                    const int targetByte = targetOffsets ? targetOffsets[targetIndex] : targetIndex;
+                    score = ComputeCharScore(queryCharAtIndex, queryLowerCharAtIndex, targetChar, targetLowerChar,
+                                             targetIndex, IsWordStart(wordStarts, targetByte), matchesSequenceLength);
+                }
+
+                const bool isValidScore = score && diagScore + score >= leftScore;
+                if (isValidScore) {
+                    matches[currentIndex] = matchesSequenceLength + 1;
+                    scores[currentIndex] = diagScore + score;
+                } else {
+                    matches[currentIndex] = -1;
+                    scores[currentIndex] = leftScore;
+                }
+            }
+        }
+    }
+
+    template<typename Policy>
+    int BasicFuzzyScorer<Policy>::ComputeCharScore(char32_t queryChar, char32_t queryCharLower, char32_t targetChar,
+                                                   char32_t targetCharLower, int targetIdx, bool isWordStart,
+                                                   int sequenceMatch) const {
+        if (queryCharLower != targetCharLower) {
+            return 0;
+        }
+
+        const ScoringWeights &weights = _policy.weights;
+
+        // Character match bonus
+        int score = weights.charMatch;
+
+        // Sequence match bonus
+        if constexpr (HasBonus(&ScoringWeights::sequence)) {
+            if (sequenceMatch > 0) {
+                score += sequenceMatch * weights.sequence;
+            }
+        }
+
+        // Same case bonus
+        if constexpr (HasBonus(&ScoringWeights::sameCase)) {
+            if (queryChar == targetChar) {
+                score += weights.sameCase;
+            }
+        }
+
+        // Start of word bonus, word starts are precomputed with CamelCase, separators and digits
+        if constexpr (HasBonus(&ScoringWeights::nameStart) || HasBonus(&ScoringWeights::wordStart)) {
+            if (targetIdx == 0) {
+                score += weights.nameStart;
+            } else if (isWordStart) {
+                score += weights.wordStart;
+            }
+        }
+
+        return score;
+    }
+
+}
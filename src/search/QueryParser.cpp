@@ -0,0 +1,73 @@
+#include "QueryParser.h"
+
+#include <algorithm>
+
+#include "FuzzyScorer.h"
+#include "Utf8.h"
+
+namespace hotline {
+
+    namespace {
+        bool IsFilterPrefix(char c) {
+            return c == '@' || c == '#';
+        }
+    }
+
+    void ParseQuery(std::string_view query, ParsedQuery &parsed) {
+        parsed.tokens.clear();
+        parsed.filters.clear();
+        parsed.mask = 0;
+        parsed.text.clear();
+        ToLower(query, parsed.lower);
+
+        bool hasFilterWords = false;
+        size_t pos = 0;
+        while (pos < query.size()) {
+            const size_t begin = query.find_first_not_of(' ', pos);
+            if (begin == std::string_view::npos) {
+                break;
+            }
+            size_t end = query.find(' ', begin);
+            if (end == std::string_view::npos) {
+                end = query.size();
+            }
+
+            pos = end;
+
+            // lone prefix is a filter still being typed, it doesn't narrow anything yet
+            if (IsFilterPrefix(query[begin])) {
+                hasFilterWords = true;
+                if (end - begin > 1) {
+                    parsed.filters.emplace_back(std::string_view(parsed.lower).substr(begin, end - begin));
+                }
+                continue;
+            }
+
+            QueryToken token;
+            token.text.assign(query.substr(begin, end - begin));
+            // lowercase keeps byte offsets, so token is cut from lowercased query at the same place
+            token.lower.assign(std::string_view(parsed.lower).substr(begin, end - begin));
+            token.mask = FuzzyScorer::ComputeCharMask(token.lower);
+            token.isAscii = IsAscii(token.text);
+            parsed.mask |= token.mask;
+            parsed.tokens.push_back(std::move(token));
+        }
+
+        if (!hasFilterWords && !parsed.tokens.empty()) {
+            parsed.text.assign(query);
+        } else {
+            // words keep their order, filters may stand anywhere in query
+            for (const auto &token: parsed.tokens) {
+                if (!parsed.text.empty()) {
+                    parsed.text += ' ';
+                }
+                parsed.text += token.text;
+            }
+            ToLower(parsed.text, parsed.lower);
+        }
+
+        std::stable_sort(parsed.tokens.begin(), parsed.tokens.end(),
+                         [](const QueryToken &a, const QueryToken &b) { return a.text.size() > b.text.size(); });
+    }
+
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace hotline {
+
+    struct QueryToken {
+        std::string text;
+        std::string lower;
+        uint64_t mask = 0;      // FuzzyScorer::ComputeCharMask of lower
+        bool isAscii = true;
+    };
+
+    // space separated words of query. Every token has to match the name on its own, in any order,
+    // so "export mesh" finds MeshExport. Words starting with '@' (category) or '#' (tag) are filters,
+    // "@render #debug shad" looks for "shad" among actions of category render tagged debug
+    struct ParsedQuery {
+        std::vector<QueryToken> tokens;     // longest first, they reject most names
+        std::vector<std::string> filters;   // lowercased with prefix, as FilterIndex keys
+        uint64_t mask = 0;                  // all token masks
+        std::string text;                   // query without filters, for exact lookup and sources
+        std::string lower;                  // text lowercased
+
+        bool IsEmpty() const { return tokens.empty() && filters.empty(); }
+        bool IsSingleToken() const { return tokens.size() == 1; }
+    };
+
+    void ParseQuery(std::string_view query, ParsedQuery &parsed);
+
+}
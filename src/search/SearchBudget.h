@@ -0,0 +1,40 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <limits>
+
+namespace hotline {
+
+    // work allowed for one step of resumable search (see ActionSet::FindVariantsStep), in scanned names
+    // and wall time. Default one is unlimited. Budget is shared by all searches of the step, and every step
+    // scans at least one chunk of names, so search always advances
+    class SearchBudget {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        SearchBudget() = default;
+        // 0 for no limit of that kind
+        SearchBudget(size_t items, std::chrono::microseconds time) {
+            if (items > 0) {
+                _items = items;
+            }
+            if (time.count() > 0) {
+                _deadline = Clock::now() + time;
+                _timed = true;
+            }
+        }
+
+        bool IsUnlimited() const { return !_timed && _items == std::numeric_limits<size_t>::max(); }
+
+        void Spend(size_t items) { _items = items < _items ? _items - items : 0; }
+
+        bool IsExhausted() const { return _items == 0 || (_timed && Clock::now() >= _deadline); }
+
+    private:
+        size_t _items = std::numeric_limits<size_t>::max();
+        Clock::time_point _deadline;
+        bool _timed = false;
+    };
+
+}
@@ -0,0 +1,336 @@
+#include "SearchIndex.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#include "FuzzyScorer.h"
+#include "StringPool.h"
+#include "Utf8.h"
+
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+#define HOTLINE_DEFERRED_BUILD_IN_CHUNKS
+#endif
+
+namespace hotline {
+
+    // derived data of deferred slots, computed from a snapshot of their names. Background thread touches
+    // nothing else, so index stays usable meanwhile
+    struct SearchIndex::DeferredBuild {
+        std::vector<Slot> slots;
+        std::vector<uint32_t> generations;      // of slots at snapshot, removed or reused ones are skipped
+        std::string nameBuffer;                 // copy of names, interned ones are released with their slots
+        std::vector<std::string_view> names;    // into nameBuffer
+        std::vector<std::string> lowerNames;
+        std::vector<uint64_t> masks;
+        std::vector<uint8_t> ascii;
+        std::vector<std::vector<uint64_t>> wordStarts;
+        std::vector<std::string> acronyms;
+        std::vector<std::string> normalized;
+        std::atomic<size_t> built{0};
+        std::atomic<bool> cancelled{false};
+        std::thread thread;
+
+        void Build(size_t begin, size_t end) {
+            for (size_t i = begin; i < end && !cancelled.load(std::memory_order_relaxed); i++) {
+                ToLower(names[i], lowerNames[i]);
+                masks[i] = FuzzyScorer::ComputeCharMask(lowerNames[i]);
+                ascii[i] = hotline::IsAscii(names[i]);
+                FuzzyScorer::ComputeWordStarts(names[i], wordStarts[i]);
+                acronyms[i] = FuzzyScorer::ComputeAcronym(names[i], wordStarts[i]);
+                normalized[i] = Normalize(names[i]);
+                built.store(i + 1, std::memory_order_release);
+            }
+        }
+    };
+
+    SearchIndex::SearchIndex(std::pmr::memory_resource *resource)
+            : _names(resource), _lowerNames(resource), _masks(resource), _ascii(resource), _alive(resource),
+              _generations(resource), _wordStarts(resource), _acronyms(resource), _slotsByAcronym(resource), _aliases(resource),
+              _slotByExact(resource), _hiddenExact(resource), _freeSlots(resource), _indexed(resource) {}
+
+    SearchIndex::~SearchIndex() {
+        if (_build && _build->thread.joinable()) {
+            _build->cancelled = true;
+            _build->thread.join();
+        }
+        StringPool &pool = SharedStringPool();
+        for (Slot slot = 0; slot < _names.size(); slot++) {
+            pool.Release(_names[slot]);
+            pool.Release(_acronyms[slot]);
+        }
+        // aliases are keys here as well
+        for (const auto &[normalized, slot]: _slotByExact) {
+            pool.Release(normalized);
+        }
+    }
+
+    void SearchIndex::AddExact(std::string_view normalized, Slot slot) {
+        if (normalized.empty()) {
+            return;
+        }
+        // key is interned only when it is taken, so every key holds one reference
+        auto found = _slotByExact.find(normalized);
+        if (found == _slotByExact.end()) {
+            _slotByExact.emplace(SharedStringPool().Intern(normalized), ExactEntry{slot, false});
+        } else if (found->second.alias) {
+            _hiddenExact.emplace(found->first, found->second);
+            found->second = {slot, false};
+        } else {
+            _hiddenExact.emplace(found->first, ExactEntry{slot, false});
+        }
+    }
+
+    void SearchIndex::RemoveExact(std::string_view normalized, Slot slot) {
+        auto found = _slotByExact.find(normalized);
+        if (found == _slotByExact.end()) {
+            return;
+        }
+        auto [begin, end] = _hiddenExact.equal_range(found->first);
+        if (found->second.slot != slot) {
+            for (auto hidden = begin; hidden != end; ++hidden) {
+                if (hidden->second.slot == slot) {
+                    _hiddenExact.erase(hidden);
+                    break;
+                }
+            }
+            return;
+        }
+        if (begin == end) {
+            const std::string_view key = found->first;
+            _slotByExact.erase(found);
+            SharedStringPool().Release(key);
+            return;
+        }
+        // hidden name first, then alias
+        auto next = begin;
+        for (auto hidden = begin; hidden != end; ++hidden) {
+            if (!hidden->second.alias) {
+                next = hidden;
+                break;
+            }
+        }
+        found->second = next->second;
+        _hiddenExact.erase(next);
+    }
+
+    SearchIndex::Slot SearchIndex::AllocateSlot(std::string_view name) {
+        Slot slot;
+        if (!_freeSlots.empty()) {
+            slot = _freeSlots.back();
+            _freeSlots.pop_back();
+        } else {
+            slot = static_cast<Slot>(_names.size());
+            _names.emplace_back();
+            _lowerNames.emplace_back();
+            _masks.push_back(0);
+            _ascii.push_back(1);
+            _wordStarts.emplace_back();
+            _acronyms.emplace_back();
+            _aliases.emplace_back();
+            _alive.push_back(0);
+            _generations.push_back(0);
+            _indexed.push_back(1);
+        }
+        _names[slot] = SharedStringPool().Intern(name);
+        _alive[slot] = 1;
+        return slot;
+    }
+
+    SearchIndex::Slot SearchIndex::Add(std::string_view name) {
+        const Slot slot = AllocateSlot(name);
+        // name is interned, lowercase one and word starts keep capacity of reused slot
+        ToLower(name, _lowerScratch);
+        _lowerNames[slot].assign(_lowerScratch);
+        _ascii[slot] = hotline::IsAscii(name);
+        FuzzyScorer::ComputeWordStarts(name, _wordStartsScratch);
+        _wordStarts[slot].assign(_wordStartsScratch.begin(), _wordStartsScratch.end());
+        const std::string acronym = FuzzyScorer::ComputeAcronym(name, _wordStartsScratch);
+        _acronyms[slot] = acronym.empty() ? std::string_view() : SharedStringPool().Intern(acronym);
+        if (!_acronyms[slot].empty()) {
+            _slotsByAcronym[_acronyms[slot]].push_back(slot);
+        }
+        AddExact(Normalize(name), slot);
+        _masks[slot] = FuzzyScorer::ComputeCharMask(_lowerNames[slot]);
+        _indexed[slot] = 1;
+        return slot;
+    }
+
+    SearchIndex::Slot SearchIndex::AddDeferred(std::string_view name) {
+        const Slot slot = AllocateSlot(name);
+        _indexed[slot] = 0;
+        _deferredCount++;
+        return slot;
+    }
+
+    void SearchIndex::StartDeferredBuild() {
+        if (_build || _deferredCount == 0) {
+            return;
+        }
+        _build = std::make_unique<DeferredBuild>();
+        DeferredBuild &build = *_build;
+        build.slots.reserve(_deferredCount);
+        build.generations.reserve(_deferredCount);
+        size_t nameBytes = 0;
+        for (Slot slot = 0; slot < _names.size(); slot++) {
+            if (_alive[slot] && !_indexed[slot]) {
+                build.slots.push_back(slot);
+                build.generations.push_back(_generations[slot]);
+                nameBytes += _names[slot].size();
+            }
+        }
+        const size_t count = build.slots.size();
+        build.nameBuffer.reserve(nameBytes);
+        build.names.reserve(count);
+        for (const Slot slot: build.slots) {
+            build.names.emplace_back(build.nameBuffer.data() + build.nameBuffer.size(), _names[slot].size());
+            build.nameBuffer.append(_names[slot]);
+        }
+        build.lowerNames.resize(count);
+        build.masks.resize(count);
+        build.ascii.resize(count);
+        build.wordStarts.resize(count);
+        build.acronyms.resize(count);
+        build.normalized.resize(count);
+#if !defined(HOTLINE_DEFERRED_BUILD_IN_CHUNKS)
+        build.thread = std::thread([&build, count]() { build.Build(0, count); });
+#endif
+    }
+
+    bool SearchIndex::AdoptDeferredBuild() {
+        if (!_build) {
+            return false;
+        }
+#if defined(HOTLINE_DEFERRED_BUILD_IN_CHUNKS)
+        const size_t begin = _build->built.load();
+        _build->Build(begin, std::min(begin + 4096, _build->slots.size()));
+#endif
+        if (_build->built.load(std::memory_order_acquire) < _build->slots.size()) {
+            return false;
+        }
+        if (_build->thread.joinable()) {
+            _build->thread.join();
+        }
+        const std::unique_ptr<DeferredBuild> build = std::move(_build);
+        for (size_t i = 0; i < build->slots.size(); i++) {
+            const Slot slot = build->slots[i];
+            // slot may be removed, or reused by Add, since snapshot
+            if (!IsCurrent(slot, build->generations[i]) || _indexed[slot]) {
+                continue;
+            }
+            _lowerNames[slot].assign(build->lowerNames[i]);
+            _masks[slot] = build->masks[i];
+            _ascii[slot] = build->ascii[i];
+            _wordStarts[slot].assign(build->wordStarts[i].begin(), build->wordStarts[i].end());
+            if (!build->acronyms[i].empty()) {
+                _acronyms[slot] = SharedStringPool().Intern(build->acronyms[i]);
+                _slotsByAcronym[_acronyms[slot]].push_back(slot);
+            }
+            AddExact(build->normalized[i], slot);
+            _indexed[slot] = 1;
+            _deferredCount--;
+        }
+        StartDeferredBuild();
+        return true;
+    }
+
+    float SearchIndex::GetBuildProgress() const {
+        if (_deferredCount == 0) {
+            return 1.0f;
+        }
+        const size_t built = _build ? _build->built.load(std::memory_order_relaxed) : 0;
+        return std::min(1.0f, static_cast<float>(built) / static_cast<float>(_deferredCount));
+    }
+
+    SearchIndex::SlotView SearchIndex::GetView(Slot slot, std::string &lowerScratch) const {
+        if (_indexed[slot]) {
+            return {_names[slot], _lowerNames[slot], _masks[slot], _ascii[slot] != 0, _wordStarts[slot].data()};
+        }
+        ToLower(_names[slot], lowerScratch);
+        return {_names[slot], lowerScratch, FuzzyScorer::ComputeCharMask(lowerScratch), hotline::IsAscii(_names[slot]),
+                nullptr};
+    }
+
+    void SearchIndex::Remove(Slot slot) {
+        if (!_alive[slot]) {
+            return;
+        }
+        _alive[slot] = 0;
+        _generations[slot]++;
+        _masks[slot] = 0;
+        if (!_indexed[slot]) {
+            _indexed[slot] = 1;
+            _deferredCount--;
+        }
+        RemoveExact(Normalize(_names[slot]), slot);
+        for (const auto &alias: _aliases[slot]) {
+            RemoveExact(alias, slot);
+        }
+        _aliases[slot].clear();
+        SharedStringPool().Release(_names[slot]);
+        _names[slot] = {};
+        _lowerNames[slot].clear();
+        if (!_acronyms[slot].empty()) {
+            auto found = _slotsByAcronym.find(_acronyms[slot]);
+            auto &slots = found->second;
+            slots.erase(std::find(slots.begin(), slots.end(), slot));
+            if (slots.empty()) {
+                _slotsByAcronym.erase(found);
+            }
+            SharedStringPool().Release(_acronyms[slot]);
+            _acronyms[slot] = {};
+        }
+        _freeSlots.push_back(slot);
+    }
+
+    void SearchIndex::Reserve(size_t count) {
+        if (count <= _freeSlots.size()) {
+            return;
+        }
+        const size_t capacity = _names.size() + count - _freeSlots.size();
+        _names.reserve(capacity);
+        _lowerNames.reserve(capacity);
+        _masks.reserve(capacity);
+        _ascii.reserve(capacity);
+        _wordStarts.reserve(capacity);
+        _acronyms.reserve(capacity);
+        _aliases.reserve(capacity);
+        _alive.reserve(capacity);
+        _generations.reserve(capacity);
+        _indexed.reserve(capacity);
+    }
+
+    std::string SearchIndex::Normalize(std::string_view name) {
+        const size_t begin = name.find_first_not_of(' ');
+        if (begin == std::string_view::npos) {
+            return {};
+        }
+        const size_t end = name.find_last_not_of(' ');
+        return ToLower(name.substr(begin, end - begin + 1));
+    }
+
+    SearchIndex::Slot SearchIndex::FindExact(std::string_view normalized) const {
+        auto found = _slotByExact.find(normalized);
+        return found != _slotByExact.end() ? found->second.slot : noSlot;
+    }
+
+    bool SearchIndex::AddAlias(Slot slot, std::string_view alias) {
+        const std::string normalized = Normalize(alias);
+        if (normalized.empty()) {
+            return false;
+        }
+        if (auto found = _slotByExact.find(normalized); found != _slotByExact.end()) {
+            return found->second.slot == slot;
+        }
+        const std::string_view interned = SharedStringPool().Intern(normalized);
+        _slotByExact.emplace(interned, ExactEntry{slot, true});
+        _aliases[slot].push_back(interned);
+        return true;
+    }
+
+    const std::pmr::vector<SearchIndex::Slot> *SearchIndex::FindAcronym(std::string_view lowerQuery) const {
+        auto found = _slotsByAcronym.find(lowerQuery);
+        return found != _slotsByAcronym.end() ? &found->second : nullptr;
+    }
+
+}
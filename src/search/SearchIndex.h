@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace hotline {
+
+    // per-name search data kept in slots. Removed slots go to free list and are reused by next Add,
+    // so adding and removing never rebuilds the index. Per-slot data lives in given memory resource,
+    // names, acronyms and aliases are interned in SharedStringPool and released with their slot
+    class SearchIndex {
+    public:
+        using Slot = uint32_t;
+        static constexpr Slot noSlot = ~Slot(0);
+
+        explicit SearchIndex(std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+        ~SearchIndex();
+
+        Slot Add(std::string_view name);
+        void Remove(Slot slot);
+
+        // bulk registration: only name is stored, derived data and lookups of the slot are built by
+        // StartDeferredBuild on a background thread and taken over by AdoptDeferredBuild. Until then the
+        // slot is matched by plain scan of its name (see GetView), FindExact and FindAcronym miss it
+        Slot AddDeferred(std::string_view name);
+        bool IsIndexed(Slot slot) const { return _indexed[slot] != 0; }
+        // builds slots deferred so far, no-op while previous build runs. Without threads (Emscripten)
+        // slots are built in chunks by AdoptDeferredBuild calls instead
+        void StartDeferredBuild();
+        // takes over finished build and starts next one for slots deferred meanwhile. True if index changed
+        bool AdoptDeferredBuild();
+        bool IsIndexReady() const { return _deferredCount == 0; }
+        // share of deferred slots built so far, 1 when ready
+        float GetBuildProgress() const;
+
+        // capacity for count more names beyond reusable free slots
+        void Reserve(size_t count);
+
+        size_t SlotCount() const { return _names.size(); }
+        size_t Size() const { return _names.size() - _freeSlots.size(); }
+        size_t FreeSlotCount() const { return _freeSlots.size(); }
+
+        bool IsAlive(Slot slot) const { return _alive[slot] != 0; }
+        // changes when slot is removed, so references to a reused slot can tell it holds another name now
+        uint32_t GetGeneration(Slot slot) const { return _generations[slot]; }
+        bool IsCurrent(Slot slot, uint32_t generation) const { return _alive[slot] && _generations[slot] == generation; }
+        // interned in SharedStringPool, valid while slot is alive
+        std::string_view GetName(Slot slot) const { return _names[slot]; }
+        std::string_view GetLowerName(Slot slot) const { return _lowerNames[slot]; }
+        uint64_t GetMask(Slot slot) const { return _masks[slot]; }
+        bool IsAscii(Slot slot) const { return _ascii[slot] != 0; }
+        const uint64_t *GetWordStarts(Slot slot) const { return _wordStarts[slot].data(); }
+        std::string_view GetAcronym(Slot slot) const { return _acronyms[slot]; }
+
+        // search data of slot. Slot waiting for deferred build gets it derived per call, lowercase name
+        // into scratch, and has no word starts (scorer computes them)
+        struct SlotView {
+            std::string_view name;
+            std::string_view lowerName;
+            uint64_t mask = 0;
+            bool isAscii = true;
+            const uint64_t *wordStarts = nullptr;
+        };
+        SlotView GetView(Slot slot, std::string &lowerScratch) const;
+
+        // slots whose acronym equals lowercase query, null if none
+        const std::pmr::vector<Slot> *FindAcronym(std::string_view lowerQuery) const;
+
+        // exact lookup over normalized names and aliases. Normalized form is lowercase without
+        // surrounding spaces. On collision names win over aliases, then the one registered first, the others
+        // stay hidden and take the key over when its owner is removed
+        static std::string Normalize(std::string_view name);
+        Slot FindExact(std::string_view normalized) const;
+
+        // false if alias is already taken by another slot, a name added later takes it over
+        bool AddAlias(Slot slot, std::string_view alias);
+        const std::pmr::vector<std::string_view> &GetAliases(Slot slot) const { return _aliases[slot]; }
+
+    private:
+        struct DeferredBuild;
+
+        struct ExactEntry {
+            Slot slot;
+            bool alias;
+        };
+
+        Slot AllocateSlot(std::string_view name);
+        void AddExact(std::string_view normalized, Slot slot);
+        void RemoveExact(std::string_view normalized, Slot slot);
+
+        std::pmr::vector<std::string_view> _names;
+        std::pmr::vector<std::pmr::string> _lowerNames;
+        std::pmr::vector<uint64_t> _masks;
+        std::pmr::vector<uint8_t> _ascii;   // detected once here, so scorer skips UTF-8 decoding for ASCII names
+        std::pmr::vector<uint8_t> _alive;
+        std::pmr::vector<uint32_t> _generations;
+        std::pmr::vector<std::pmr::vector<uint64_t>> _wordStarts;   // see FuzzyScorer::ComputeWordStarts
+        std::pmr::vector<std::string_view> _acronyms;
+        std::pmr::unordered_map<std::string_view, std::pmr::vector<Slot>> _slotsByAcronym;
+        std::pmr::vector<std::pmr::vector<std::string_view>> _aliases;     // normalized
+        std::pmr::unordered_map<std::string_view, ExactEntry> _slotByExact;
+        std::pmr::unordered_multimap<std::string_view, ExactEntry> _hiddenExact;  // keys shared with _slotByExact
+        std::pmr::vector<Slot> _freeSlots;
+        std::pmr::vector<uint8_t> _indexed;     // 0 for slots waiting for deferred build
+        size_t _deferredCount = 0;              // alive slots waiting for deferred build
+        std::unique_ptr<DeferredBuild> _build;
+
+        // computed here first, so adding does not allocate outside of the resource once they have grown
+        std::string _lowerScratch;
+        std::vector<uint64_t> _wordStartsScratch;
+    };
+
+}
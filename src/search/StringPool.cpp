@@ -0,0 +1,55 @@
+#include "StringPool.h"
+
+#include <cstring>
+
+namespace hotline {
+
+    std::string_view StringPool::Intern(std::string_view text) {
+        if (text.empty()) {
+            return {};
+        }
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto found = _references.find(text);
+        if (found != _references.end()) {
+            found->second++;
+            return found->first;
+        }
+
+        auto *storage = static_cast<char *>(_storage.allocate(text.size(), 1));
+        std::memcpy(storage, text.data(), text.size());
+        _byteCount += text.size();
+        return _references.emplace(std::string_view(storage, text.size()), 1).first->first;
+    }
+
+    void StringPool::Release(std::string_view interned) {
+        if (interned.empty()) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto found = _references.find(interned);
+        if (found == _references.end() || --found->second > 0) {
+            return;
+        }
+        const std::string_view stored = found->first;
+        _references.erase(found);
+        _byteCount -= stored.size();
+        _storage.deallocate(const_cast<char *>(stored.data()), stored.size(), 1);
+    }
+
+    size_t StringPool::GetStringCount() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _references.size();
+    }
+
+    size_t StringPool::GetByteCount() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _byteCount;
+    }
+
+    StringPool &SharedStringPool() {
+        // never destroyed, so sets and actions destroyed at exit can still release their strings
+        static StringPool *pool = new StringPool();
+        return *pool;
+    }
+
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+
+namespace hotline {
+
+    // interned strings: every distinct string is stored once and its views stay valid while it is referenced.
+    // Every Intern adds a reference and has to be paired with Release, the last Release frees the storage for
+    // next strings. Small strings share pooled chunks, so interning many names allocates only now and then.
+    // Interning is thread-safe, reading interned views needs no lock
+    class StringPool {
+    public:
+        StringPool() = default;
+        StringPool(const StringPool &) = delete;
+        StringPool &operator=(const StringPool &) = delete;
+
+        std::string_view Intern(std::string_view text);
+        // text has to be a view returned by Intern
+        void Release(std::string_view interned);
+
+        size_t GetStringCount() const;
+        size_t GetByteCount() const;
+
+    private:
+        std::pmr::unsynchronized_pool_resource _storage;
+        std::unordered_map<std::string_view, uint32_t> _references;
+        size_t _byteCount = 0;
+        mutable std::mutex _mutex;
+    };
+
+    // pool shared by action names, argument labels and search indexes
+    StringPool &SharedStringPool();
+
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+namespace hotline {
+
+    struct ScoredIndex {
+        int score = 0;
+        int index = 0;
+    };
+
+    // higher score first, lower index first on ties so results are stable between runs
+    inline bool IsBetterScored(const ScoredIndex &a, const ScoredIndex &b) {
+        return a.score != b.score ? a.score > b.score : a.index < b.index;
+    }
+
+    // keeps best `limit` entries in a heap with the worst one on top, so rejecting is O(1).
+    // Heap is std::pmr::vector when collector should allocate from given memory resource
+    template<typename T, typename IsBetter, typename Container = std::vector<T>>
+    class TopK {
+    public:
+        explicit TopK(size_t limit = 0, IsBetter isBetter = IsBetter()) : _limit(limit), _isBetter(isBetter) {}
+        explicit TopK(const typename Container::allocator_type &allocator)
+                : _limit(0), _isBetter(IsBetter()), _heap(allocator) {}
+
+        void Reset(size_t limit) {
+            _limit = limit;
+            _heap.clear();
+        }
+
+        void Push(const T &value) {
+            if (_limit == 0) {
+                return;
+            }
+            if (_heap.size() < _limit) {
+                _heap.push_back(value);
+                std::push_heap(_heap.begin(), _heap.end(), _isBetter);
+            } else if (_isBetter(value, _heap.front())) {
+                std::pop_heap(_heap.begin(), _heap.end(), _isBetter);
+                _heap.back() = value;
+                std::push_heap(_heap.begin(), _heap.end(), _isBetter);
+            }
+        }
+
+        // true if value would be dropped anyway, lets callers skip expensive work
+        bool IsFullWithBetterThan(const T &value) const {
+            return _heap.size() >= _limit && !_isBetter(value, _heap.front());
+        }
+
+        size_t Size() const { return _heap.size(); }
+
+        // copy of collected entries, best first, collecting may go on
+        template<typename Out>
+        void GetSorted(Out &out) const {
+            out.assign(_heap.begin(), _heap.end());
+            std::sort(out.begin(), out.end(), _isBetter);
+        }
+
+        // moves collected entries to out, best first, and leaves collector empty
+        void TakeSorted(Container &out) {
+            std::sort_heap(_heap.begin(), _heap.end(), _isBetter);
+            out.swap(_heap);
+            _heap.clear();
+        }
+
+    private:
+        size_t _limit;
+        IsBetter _isBetter;
+        Container _heap;
+    };
+
+    struct ScoredIndexIsBetter {
+        bool operator()(const ScoredIndex &a, const ScoredIndex &b) const { return IsBetterScored(a, b); }
+    };
+
+    using ScoredIndexTopK = TopK<ScoredIndex, ScoredIndexIsBetter>;
+}
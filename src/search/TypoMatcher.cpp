@@ -0,0 +1,106 @@
+#include "TypoMatcher.h"
+
+#include <algorithm>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace hotline {
+
+    void TypoMatcher::SetQuery(std::string_view queryLower, int maxEdits) {
+        for (const char c: _query) {
+            _peq[static_cast<unsigned char>(c)] = 0;
+        }
+        _query.clear();
+        _maxEdits = 0;
+
+        if (queryLower.empty() || queryLower.size() > 64) {
+            return;
+        }
+        _query.assign(queryLower);
+        for (size_t i = 0; i < _query.size(); i++) {
+            _peq[static_cast<unsigned char>(_query[i])] |= uint64_t(1) << i;
+        }
+        _lastBit = uint64_t(1) << (_query.size() - 1);
+        _maxEdits = std::min(maxEdits, static_cast<int>(_query.size()) / 3);
+    }
+
+    bool TypoMatcher::MayMatch(uint64_t queryMask, uint64_t targetMask) const {
+        return PopCount(queryMask & ~targetMask) <= _maxEdits;
+    }
+
+    TypoMatcher::Match TypoMatcher::Find(std::string_view targetLower) const {
+        Match best;
+        const int querySize = static_cast<int>(_query.size());
+        if (_maxEdits <= 0 || static_cast<int>(targetLower.size()) < querySize - _maxEdits) {
+            return best;
+        }
+
+        // column of distances between query prefixes and best substring ending at current byte,
+        // kept as vertical deltas. Top row stays zero, so match may start anywhere
+        uint64_t vp = ~uint64_t(0);
+        uint64_t vn = 0;
+        uint64_t d0 = 0;
+        uint64_t prevEq = 0;
+        int distance = querySize;
+        for (size_t i = 0; i < targetLower.size(); i++) {
+            const uint64_t eq = _peq[static_cast<unsigned char>(targetLower[i])];
+            const uint64_t transposition = ((~d0 & eq) << 1) & prevEq;
+            d0 = (((eq & vp) + vp) ^ vp) | eq | vn | transposition;
+            const uint64_t hp = vn | ~(d0 | vp);
+            const uint64_t hn = vp & d0;
+            if (hp & _lastBit) {
+                distance++;
+            } else if (hn & _lastBit) {
+                distance--;
+            }
+            const uint64_t x = hp << 1;
+            vn = x & d0;
+            vp = (hn << 1) | ~(x | d0);
+            prevEq = eq;
+
+            if (distance <= _maxEdits && (best.edits < 0 || distance < best.edits)) {
+                best.edits = distance;
+                best.end = static_cast<int>(i) + 1;
+                if (distance == 0) {
+                    break;
+                }
+            }
+        }
+        return best;
+    }
+
+    void TypoMatcher::GetPositions(std::string_view targetLower, const Match &match, std::vector<int> &positions) const {
+        if (match.edits < 0) {
+            return;
+        }
+        const int start = std::max(0, match.end - static_cast<int>(_query.size()) - match.edits);
+        // query characters lost to edits are skipped, at most match.edits of them
+        size_t queryIdx = 0;
+        size_t skipsLeft = match.edits;
+        for (int i = start; i < match.end && queryIdx < _query.size(); i++) {
+            const size_t last = std::min(_query.size() - 1, queryIdx + skipsLeft);
+            for (size_t j = queryIdx; j <= last; j++) {
+                if (targetLower[i] != _query[j]) {
+                    continue;
+                }
+                // continuation bytes of multibyte characters are not drawn separately
+                if ((static_cast<unsigned char>(targetLower[i]) & 0xC0) != 0x80) {
+                    positions.push_back(i);
+                }
+                skipsLeft -= j - queryIdx;
+                queryIdx = j + 1;
+                break;
+            }
+        }
+    }
+
+    int TypoMatcher::PopCount(uint64_t bits) {
+#if defined(_MSC_VER)
+        return static_cast<int>(__popcnt64(bits));
+#else
+        return __builtin_popcountll(bits);
+#endif
+    }
+
+}
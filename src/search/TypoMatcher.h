@@ -0,0 +1,45 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace hotline {
+
+    // finds query in lowercase names allowing up to maxEdits edits (insertion, deletion, substitution,
+    // swap of neighbour characters). Bit-parallel edit distance (Myers, with Hyyro transpositions),
+    // one pass over the name with a few word operations per byte. Query is limited to 64 bytes,
+    // edits are counted in bytes
+    class TypoMatcher {
+    public:
+        struct Match {
+            int edits = -1;     // -1 if nothing found within allowed edits
+            int end = 0;        // byte offset after best matching substring
+        };
+
+        // queries shorter than 3 bytes per allowed edit get less edits, they would match almost anything
+        void SetQuery(std::string_view queryLower, int maxEdits);
+
+        bool IsEnabled() const { return _maxEdits > 0; }
+        int GetMaxEdits() const { return _maxEdits; }
+
+        // cheap check before Find: every query character missing in the name costs at least one edit
+        bool MayMatch(uint64_t queryMask, uint64_t targetMask) const;
+
+        Match Find(std::string_view targetLower) const;
+
+        // appends byte offsets of query characters greedily found in matched substring, for highlighting
+        void GetPositions(std::string_view targetLower, const Match &match, std::vector<int> &positions) const;
+
+    private:
+        static int PopCount(uint64_t bits);
+
+        std::array<uint64_t, 256> _peq{};   // bit i set for bytes equal to query[i]
+        std::string _query;
+        uint64_t _lastBit = 0;
+        int _maxEdits = 0;
+    };
+
+}
@@ -0,0 +1,169 @@
+#include "Utf8.h"
+
+namespace hotline {
+
+    bool IsAscii(std::string_view text) {
+        unsigned char combined = 0;
+        for (const char c: text) {
+            combined |= static_cast<unsigned char>(c);
+        }
+        return combined < 0x80;
+    }
+
+    char32_t DecodeUtf8(std::string_view text, size_t &pos) {
+        const auto lead = static_cast<unsigned char>(text[pos]);
+        if (lead < 0x80) {
+            pos++;
+            return lead;
+        }
+
+        int length;
+        char32_t codePoint;
+        if ((lead & 0xE0) == 0xC0) {
+            length = 2;
+            codePoint = lead & 0x1F;
+        } else if ((lead & 0xF0) == 0xE0) {
+            length = 3;
+            codePoint = lead & 0x0F;
+        } else if ((lead & 0xF8) == 0xF0) {
+            length = 4;
+            codePoint = lead & 0x07;
+        } else {
+            pos++;
+            return 0xFFFD;
+        }
+
+        if (pos + length > text.size()) {
+            pos++;
+            return 0xFFFD;
+        }
+        for (int i = 1; i < length; i++) {
+            const auto continuation = static_cast<unsigned char>(text[pos + i]);
+            if ((continuation & 0xC0) != 0x80) {
+                pos++;
+                return 0xFFFD;
+            }
+            codePoint = (codePoint << 6) | (continuation & 0x3F);
+        }
+        pos += length;
+        return codePoint;
+    }
+
+    void DecodeUtf8(std::string_view text, std::u32string &out, std::vector<int> *offsets) {
+        out.clear();
+        if (offsets) {
+            offsets->clear();
+        }
+        size_t pos = 0;
+        while (pos < text.size()) {
+            if (offsets) {
+                offsets->push_back(static_cast<int>(pos));
+            }
+            out.push_back(DecodeUtf8(text, pos));
+        }
+    }
+
+    void AppendUtf8(std::string &out, char32_t codePoint) {
+        if (codePoint < 0x80) {
+            out.push_back(static_cast<char>(codePoint));
+        } else if (codePoint < 0x800) {
+            out.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+            out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+        } else if (codePoint < 0x10000) {
+            out.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+        } else {
+            out.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+            out.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+        }
+    }
+
+    char32_t FoldCase(char32_t codePoint) {
+        if (codePoint < 0x80) {
+            return asciiLower.values[codePoint];
+        }
+        // Latin-1 Supplement, except multiplication sign
+        if (codePoint >= 0xC0 && codePoint <= 0xDE && codePoint != 0xD7) {
+            return codePoint + 0x20;
+        }
+        // Latin Extended-A: pairs of upper/lower, odd ranges around 0x130 and 0x178
+        if (codePoint >= 0x100 && codePoint <= 0x137 && codePoint != 0x130) {
+            return codePoint | 1;
+        }
+        if (codePoint >= 0x139 && codePoint <= 0x148) {
+            return (codePoint & 1) ? codePoint + 1 : codePoint;
+        }
+        if (codePoint >= 0x14A && codePoint <= 0x177) {
+            return codePoint | 1;
+        }
+        if (codePoint == 0x179 || codePoint == 0x17B || codePoint == 0x17D) {
+            return codePoint + 1;
+        }
+        // Greek capitals (0x3A2 is unassigned)
+        if (codePoint >= 0x391 && codePoint <= 0x3A9 && codePoint != 0x3A2) {
+            return codePoint + 0x20;
+        }
+        // Cyrillic: Ѐ..Џ and А..Я
+        if (codePoint >= 0x400 && codePoint <= 0x40F) {
+            return codePoint + 0x50;
+        }
+        if (codePoint >= 0x410 && codePoint <= 0x42F) {
+            return codePoint + 0x20;
+        }
+        // Cyrillic supplement pairs (Ѡ..ҁ, Ҋ..ҿ, Ӑ..ӿ), Ӂ..ӎ start with odd upper, Ӏ folds to ӏ
+        if ((codePoint >= 0x460 && codePoint <= 0x481) || (codePoint >= 0x48A && codePoint <= 0x4BF) ||
+            (codePoint >= 0x4D0 && codePoint <= 0x4FF)) {
+            return codePoint | 1;
+        }
+        if (codePoint >= 0x4C1 && codePoint <= 0x4CE) {
+            return (codePoint & 1) ? codePoint + 1 : codePoint;
+        }
+        if (codePoint == 0x4C0) {
+            return 0x4CF;
+        }
+        // fullwidth Latin
+        if (codePoint >= 0xFF21 && codePoint <= 0xFF3A) {
+            return codePoint + 0x20;
+        }
+        return codePoint;
+    }
+
+    void ToLower(std::string_view text, std::string &out) {
+        out.clear();
+        if (IsAscii(text)) {
+            out.resize(text.size());
+            for (size_t i = 0; i < text.size(); i++) {
+                out[i] = ToLowerAscii(text[i]);
+            }
+            return;
+        }
+
+        out.reserve(text.size());
+        size_t pos = 0;
+        while (pos < text.size()) {
+            const size_t start = pos;
+            const char32_t codePoint = DecodeUtf8(text, pos);
+            if (codePoint == 0xFFFD && pos == start + 1) {
+                // keep malformed byte as is, so offsets still match original text
+                out.push_back(text[start]);
+            } else {
+                AppendUtf8(out, FoldCase(codePoint));
+            }
+        }
+    }
+
+    std::string ToLower(std::string_view text) {
+        std::string out;
+        ToLower(text, out);
+        return out;
+    }
+
+    size_t NextCodePoint(std::string_view text, size_t pos) {
+        DecodeUtf8(text, pos);
+        return pos;
+    }
+
+}
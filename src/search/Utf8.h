@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace hotline {
+
+    // lowercase for ASCII letters, every other byte maps to itself
+    struct AsciiLowerTable {
+        unsigned char values[256];
+
+        constexpr AsciiLowerTable() : values() {
+            for (int c = 0; c < 256; c++) {
+                values[c] = static_cast<unsigned char>(c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c);
+            }
+        }
+    };
+
+    inline constexpr AsciiLowerTable asciiLower{};
+
+    inline char ToLowerAscii(char c) {
+        return static_cast<char>(asciiLower.values[static_cast<unsigned char>(c)]);
+    }
+
+    bool IsAscii(std::string_view text);
+
+    // decodes code point at pos and moves pos past it. Malformed sequences give U+FFFD and advance by one byte
+    char32_t DecodeUtf8(std::string_view text, size_t &pos);
+
+    // whole text, offsets (if not null) receive byte offset of every code point
+    void DecodeUtf8(std::string_view text, std::u32string &out, std::vector<int> *offsets);
+
+    void AppendUtf8(std::string &out, char32_t codePoint);
+
+    // simple one-to-one case folding (Latin, Greek, Cyrillic, fullwidth Latin). Only pairs with equal
+    // UTF-8 length are folded, so lowercase text keeps byte offsets of original
+    char32_t FoldCase(char32_t codePoint);
+
+    // ASCII text is lowered through table, other text is decoded and case folded
+    void ToLower(std::string_view text, std::string &out);
+    std::string ToLower(std::string_view text);
+
+    // offset of code point following the one at pos
+    size_t NextCodePoint(std::string_view text, size_t pos);
+
+}
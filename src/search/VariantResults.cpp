@@ -0,0 +1,64 @@
+#include "VariantResults.h"
+
+#include <algorithm>
+
+namespace hotline {
+
+    void VariantResults::Clear() {
+        _handles.clear();
+        _positions.clear();
+        _sourceNames.clear();
+        _handleStart = 0;
+    }
+
+    std::vector<int> &VariantResults::BeginHandle() {
+        _handleStart = _positions.size();
+        return _positions;
+    }
+
+    void VariantResults::AddHandle(VariantHandle handle, std::string_view sourceName) {
+        handle.positionOffset = static_cast<uint32_t>(_handleStart);
+        handle.positionCount = static_cast<uint16_t>(_positions.size() - _handleStart);
+        handle.sourceNameOffset = static_cast<uint32_t>(_sourceNames.size());
+        handle.sourceNameSize = static_cast<uint32_t>(sourceName.size());
+        _sourceNames.append(sourceName);
+        _handles.push_back(handle);
+        _handleStart = _positions.size();
+    }
+
+    void VariantResults::Append(const VariantResults &other, uint32_t scope) {
+        const auto positionShift = static_cast<uint32_t>(_positions.size());
+        const auto sourceNameShift = static_cast<uint32_t>(_sourceNames.size());
+        _positions.insert(_positions.end(), other._positions.begin(), other._positions.end());
+        _sourceNames.append(other._sourceNames);
+        for (VariantHandle handle: other._handles) {
+            handle.positionOffset += positionShift;
+            handle.sourceNameOffset += sourceNameShift;
+            handle.scope = scope;
+            _handles.push_back(handle);
+        }
+        _handleStart = _positions.size();
+    }
+
+    void VariantResults::Sort() {
+        // sets order their ties by slot, then source actions by name as added. Ordering ties by scope and
+        // that gives the order stable sort would keep, without its temporary buffer
+        std::sort(_handles.begin(), _handles.end(), [](const VariantHandle &a, const VariantHandle &b) {
+            if (IsBetterVariant(a, b) || IsBetterVariant(b, a)) {
+                return IsBetterVariant(a, b);
+            }
+            if (a.scope != b.scope) {
+                return a.scope < b.scope;
+            }
+            return a.slot != b.slot ? a.slot < b.slot : a.sourceNameOffset < b.sourceNameOffset;
+        });
+    }
+
+    void VariantResults::Truncate(size_t limit) {
+        // positions of dropped handles stay in buffers until Clear
+        if (_handles.size() > limit) {
+            _handles.resize(limit);
+        }
+    }
+
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "FuzzyScorer.h"
+#include "SearchIndex.h"
+
+namespace hotline {
+
+    // compact search result. Name and argument labels stay in the action set and are resolved by slot when
+    // drawn, match positions and names of source actions are kept in shared buffers of VariantResults.
+    // Handle of an action removed since search resolves to empty name and no arguments
+    struct VariantHandle {
+        int score = 0;
+        MatchKind kind = MatchKind::Subsequence;
+        uint8_t typos = 0;
+        uint16_t positionCount = 0;
+        uint32_t positionOffset = 0;            // into VariantResults::positions
+        SearchIndex::Slot slot = SearchIndex::noSlot;   // noSlot for source actions
+        uint32_t generation = 0;                // of slot, see SearchIndex::IsCurrent
+        uint32_t sourceNameOffset = 0;          // into VariantResults::sourceNames, for source actions
+        uint32_t sourceNameSize = 0;
+        uint32_t scope = 0;                     // index of set in ActionSetGroup which found this variant
+
+        bool IsSource() const { return slot == SearchIndex::noSlot; }
+    };
+
+    // same order as IsBetterFuzzyScore
+    inline bool IsBetterVariant(const VariantHandle &a, const VariantHandle &b) {
+        if (a.kind != b.kind) {
+            return a.kind < b.kind;
+        }
+        return a.typos != b.typos ? a.typos < b.typos : a.score > b.score;
+    }
+
+    // results of one search, best first. Kept by caller and refilled by next search, so once buffers
+    // have grown searching allocates nothing
+    class VariantResults {
+    public:
+        void Clear();
+
+        size_t Size() const { return _handles.size(); }
+        bool IsEmpty() const { return _handles.empty(); }
+        const VariantHandle &operator[](size_t idx) const { return _handles[idx]; }
+        const std::vector<VariantHandle> &GetHandles() const { return _handles; }
+
+        // match positions of next added handle are appended to returned buffer, as byte offsets in name.
+        // AddHandle takes all of them appended since BeginHandle
+        std::vector<int> &BeginHandle();
+        void AddHandle(VariantHandle handle, std::string_view sourceName = {});
+        // all handles of other, scope set to given one
+        void Append(const VariantResults &other, uint32_t scope);
+
+        // ties keep their order by scope and then by addition, so results are deterministic
+        void Sort();
+        void Truncate(size_t limit);
+
+        const int *GetPositions(const VariantHandle &handle) const { return _positions.data() + handle.positionOffset; }
+        std::string_view GetSourceName(const VariantHandle &handle) const {
+            return std::string_view(_sourceNames).substr(handle.sourceNameOffset, handle.sourceNameSize);
+        }
+        // source name, or name in index of the set which found handle. Empty if action was removed since
+        std::string_view GetName(const VariantHandle &handle, const SearchIndex &index) const {
+            if (handle.IsSource()) {
+                return GetSourceName(handle);
+            }
+            return index.IsCurrent(handle.slot, handle.generation) ? index.GetName(handle.slot) : std::string_view();
+        }
+
+    private:
+        std::vector<VariantHandle> _handles;
+        std::vector<int> _positions;
+        std::string _sourceNames;
+        size_t _handleStart = 0;    // positions of handle being added start here
+    };
+
+}
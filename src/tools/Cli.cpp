@@ -0,0 +1,398 @@
+// headless hotline: runs commands or fuzzy queries against an ActionSet without ImGui, GLFW or OpenGL.
+//   hotline_cli -a actions.txt script.txt        executes "name arg1 arg2" lines, quotes keep spaces in arguments
+//   hotline_cli -a actions.txt -q                reads queries from stdin and prints ranked results
+//   hotline_cli -g 100000 -q -t < queries.txt    measures search on generated actions
+// Actions file has one action per line: name followed by arguments as type:label, types are int, unsigned,
+// float, bool and string. Executed actions print their name and parsed arguments.
+// Exit code in command mode is 0 if every command executed, 1 otherwise, 2 on usage errors
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "../ActionSet.h"
+#include "../search/StringPool.h"
+
+namespace {
+    enum class ArgType {
+        Int,
+        Unsigned,
+        Float,
+        Bool,
+        String
+    };
+
+    struct ArgSpec {
+        ArgType type;
+        std::string label;
+    };
+
+    bool ParseArgType(std::string_view text, ArgType &type) {
+        static const std::pair<std::string_view, ArgType> types[] = {
+                {"int",      ArgType::Int},
+                {"unsigned", ArgType::Unsigned},
+                {"float",    ArgType::Float},
+                {"bool",     ArgType::Bool},
+                {"string",   ArgType::String},
+        };
+        for (const auto &[name, value]: types) {
+            if (text == name) {
+                type = value;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // whole string has to be the value, "12abc" is not 12
+    bool IsValidArgument(ArgType type, const std::string &value) {
+        if (value.empty()) {
+            return type == ArgType::String;
+        }
+        const char *begin = value.c_str();
+        char *end = nullptr;
+        errno = 0;
+        switch (type) {
+            case ArgType::Int:
+                std::strtoll(begin, &end, 10);
+                break;
+            case ArgType::Unsigned:
+                if (value[0] == '-') {
+                    return false;
+                }
+                std::strtoull(begin, &end, 10);
+                break;
+            case ArgType::Float:
+                std::strtod(begin, &end);
+                break;
+            case ArgType::Bool:
+                return value == "true" || value == "false" || value == "1" || value == "0";
+            case ArgType::String:
+                return true;
+        }
+        return errno == 0 && end == begin + value.size();
+    }
+
+    // argument types are known only at runtime, so this is BaseAction directly instead of Action template
+    class CliAction : public BaseAction {
+    public:
+        CliAction(const std::string &name, std::vector<ArgSpec> args)
+                : _name(hotline::SharedStringPool().Intern(name)), _args(std::move(args)) {
+            for (const auto &arg: _args) {
+                _labels.push_back(hotline::SharedStringPool().Intern(arg.label));
+                _values.emplace_back();
+                if (arg.type == ArgType::Bool) {
+                    _values.back().Build({"true", "false"});
+                }
+            }
+        }
+
+        CliAction(const CliAction &) = delete;
+        CliAction &operator=(const CliAction &) = delete;
+
+        ~CliAction() override {
+            hotline::SharedStringPool().Release(_name);
+            for (const auto label: _labels) {
+                hotline::SharedStringPool().Release(label);
+            }
+        }
+
+        // there is no provider frontend to ask for missing arguments
+        ArgumentProvidingState UpdateProviding() override {
+            return Cancelled;
+        }
+
+        ActionStartResult Start(const std::vector<std::string> &stringArgs) override {
+            if (stringArgs.size() < _args.size()) {
+                return ActionStartResult::Failure;
+            }
+            for (size_t i = 0; i < _args.size(); i++) {
+                if (!IsValidArgument(_args[i].type, stringArgs[i])) {
+                    std::fprintf(stderr, "%.*s: '%s' is not valid value for %s\n", static_cast<int>(_name.size()),
+                                 _name.data(), stringArgs[i].c_str(), _args[i].label.c_str());
+                    return ActionStartResult::InvalidArguments;
+                }
+            }
+            std::printf("%.*s", static_cast<int>(_name.size()), _name.data());
+            for (size_t i = 0; i < _args.size(); i++) {
+                std::printf(" %s=%s", _args[i].label.c_str(), stringArgs[i].c_str());
+            }
+            std::printf("\n");
+            return ActionStartResult::Success;
+        }
+
+        std::string_view GetName() const override {
+            return _name;
+        }
+
+        const std::vector<std::string_view> &GetArguments() const override {
+            return _labels;
+        }
+
+        const hotline::PrefixIndex *GetArgumentValueIndex(size_t argIdx) override {
+            return argIdx < _values.size() && !_values[argIdx].IsEmpty() ? &_values[argIdx] : nullptr;
+        }
+
+    private:
+        std::string_view _name;
+        std::vector<ArgSpec> _args;
+        std::vector<std::string_view> _labels;
+        std::vector<hotline::PrefixIndex> _values;
+    };
+
+    using ActionEntries = std::vector<std::pair<std::string, std::unique_ptr<BaseAction>>>;
+
+    bool LoadActions(const std::string &path, ActionEntries &actions) {
+        std::ifstream file(path);
+        if (!file) {
+            std::fprintf(stderr, "can't open %s\n", path.c_str());
+            return false;
+        }
+        int lineNumber = 0;
+        for (std::string line; std::getline(file, line);) {
+            lineNumber++;
+            std::vector<std::string> words;
+            size_t pos = 0;
+            while ((pos = line.find_first_not_of(" \t\r", pos)) != std::string::npos) {
+                const size_t end = line.find_first_of(" \t\r", pos);
+                words.push_back(line.substr(pos, end - pos));
+                pos = end;
+            }
+            if (words.empty() || words[0][0] == '#') {
+                continue;
+            }
+            std::vector<ArgSpec> args;
+            for (size_t i = 1; i < words.size(); i++) {
+                const size_t colon = words[i].find(':');
+                ArgSpec arg{};
+                if (colon == std::string::npos || !ParseArgType(std::string_view(words[i]).substr(0, colon), arg.type)) {
+                    std::fprintf(stderr, "%s:%d: bad argument '%s', expected type:label\n", path.c_str(), lineNumber,
+                                 words[i].c_str());
+                    return false;
+                }
+                arg.label = words[i].substr(colon + 1);
+                args.push_back(std::move(arg));
+            }
+            actions.emplace_back(words[0], std::make_unique<CliAction>(words[0], std::move(args)));
+        }
+        return true;
+    }
+
+    // CamelCase names from a small vocabulary, so queries hit realistic amounts of candidates
+    void GenerateActions(size_t count, ActionEntries &actions) {
+        static const char *verbs[] = {"Open", "Close", "Spawn", "Toggle", "Reload", "Select", "Delete", "Rename",
+                                      "Export", "Import", "Find", "Bake"};
+        static const char *nouns[] = {"Asset", "Scene", "Light", "Camera", "Material", "Shader", "Texture", "Mesh",
+                                      "Script", "Layer", "Prefab", "Animation", "Sound"};
+        const size_t verbCount = std::size(verbs);
+        const size_t nounCount = std::size(nouns);
+        for (size_t i = 0; i < count; i++) {
+            std::string name = verbs[i % verbCount];
+            name += nouns[(i / verbCount) % nounCount];
+            name += std::to_string(i / (verbCount * nounCount));
+            std::vector<ArgSpec> args;
+            if (i % 3 == 1) {
+                args.push_back({ArgType::Int, "count"});
+            } else if (i % 3 == 2) {
+                args.push_back({ArgType::String, "name"});
+                args.push_back({ArgType::Bool, "enabled"});
+            }
+            actions.emplace_back(name, std::make_unique<CliAction>(name, std::move(args)));
+        }
+    }
+
+    const char *GetStatusText(hotline::CommandStatus status) {
+        switch (status) {
+            case hotline::CommandStatus::Executed:
+                return "ok";
+            case hotline::CommandStatus::UnknownAction:
+                return "unknown action";
+            case hotline::CommandStatus::Unavailable:
+                return "action is unavailable";
+            case hotline::CommandStatus::MissingArguments:
+                return "missing arguments";
+            case hotline::CommandStatus::InvalidArguments:
+                return "invalid arguments";
+            case hotline::CommandStatus::Busy:
+                return "busy";
+        }
+        return "unknown action";
+    }
+
+    const char *GetKindText(hotline::MatchKind kind) {
+        switch (kind) {
+            case hotline::MatchKind::Exact:
+                return "exact";
+            case hotline::MatchKind::Acronym:
+                return "acronym";
+            case hotline::MatchKind::Subsequence:
+                return "fuzzy";
+            case hotline::MatchKind::Typo:
+                return "typo";
+        }
+        return "fuzzy";
+    }
+
+    bool IsTerminal(FILE *file) {
+#if defined(_WIN32)
+        return _isatty(_fileno(file)) != 0;
+#else
+        return isatty(fileno(file)) != 0;
+#endif
+    }
+
+    int RunCommands(hotline::ActionSet &actions, std::istream &input, const std::string &inputName) {
+        int result = 0;
+        int lineNumber = 0;
+        for (std::string line; std::getline(input, line);) {
+            lineNumber++;
+            const size_t start = line.find_first_not_of(" \t\r");
+            if (start == std::string::npos || line[start] == '#') {
+                continue;
+            }
+            if (line.back() == '\r') {
+                line.pop_back();
+            }
+            const hotline::CommandStatus status = actions.ExecuteCommand(line.substr(start));
+            if (status != hotline::CommandStatus::Executed) {
+                std::fprintf(stderr, "%s:%d: %s: %s\n", inputName.c_str(), lineNumber, GetStatusText(status),
+                             line.c_str());
+                result = 1;
+            }
+            std::fflush(stdout);
+        }
+        return result;
+    }
+
+    void RunQueries(hotline::ActionSet &actions, std::istream &input, size_t limit, bool printTime) {
+        const bool prompt = IsTerminal(stdin);
+        if (prompt) {
+            std::printf("> ");
+            std::fflush(stdout);
+        }
+        for (std::string query; std::getline(input, query);) {
+            if (!query.empty() && query.back() == '\r') {
+                query.pop_back();
+            }
+            const auto start = std::chrono::steady_clock::now();
+            const std::vector<hotline::ActionVariant> variants = actions.FindVariants(query, limit);
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+
+            for (size_t i = 0; i < variants.size(); i++) {
+                const hotline::ActionVariant &variant = variants[i];
+                std::printf("%3zu %6d %-11s %s", i + 1, variant.score, GetKindText(variant.kind),
+                            variant.actionName.c_str());
+                for (const auto &argument: variant.actionArguments) {
+                    std::printf(" <%s>", argument.c_str());
+                }
+                std::printf("\n");
+            }
+            if (printTime) {
+                const auto us = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+                std::printf("%zu results in %lld us\n", variants.size(), static_cast<long long>(us));
+            }
+            if (prompt) {
+                std::printf("> ");
+            }
+            std::fflush(stdout);
+        }
+    }
+
+    void PrintUsage(const char *program) {
+        std::fprintf(stderr,
+                     "usage: %s [options] [script]\n"
+                     "  -a, --actions FILE   register actions from FILE, \"name type:label...\" per line\n"
+                     "  -g, --generate N     register N generated actions\n"
+                     "  -q, --query          print ranked results for each input line instead of executing it\n"
+                     "  -n, --limit N        results per query, 10 by default\n"
+                     "  -e, --typos N        allowed typos in queries, 0 by default\n"
+                     "  -t, --time           print search time of each query\n"
+                     "commands or queries are read from script, or from stdin without it\n",
+                     program);
+    }
+}
+
+int main(int argc, char **argv) {
+    std::vector<std::string> actionFiles;
+    size_t generateCount = 0;
+    bool queryMode = false;
+    size_t limit = 10;
+    int typos = 0;
+    bool printTime = false;
+    std::string scriptPath;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string_view arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if ((arg == "-a" || arg == "--actions") && hasValue) {
+            actionFiles.emplace_back(argv[++i]);
+        } else if ((arg == "-g" || arg == "--generate") && hasValue) {
+            generateCount = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "-q" || arg == "--query") {
+            queryMode = true;
+        } else if ((arg == "-n" || arg == "--limit") && hasValue) {
+            limit = std::strtoull(argv[++i], nullptr, 10);
+        } else if ((arg == "-e" || arg == "--typos") && hasValue) {
+            typos = std::atoi(argv[++i]);
+        } else if (arg == "-t" || arg == "--time") {
+            printTime = true;
+        } else if (arg == "-h" || arg == "--help") {
+            PrintUsage(argv[0]);
+            return 0;
+        } else if (!arg.empty() && arg[0] != '-' && scriptPath.empty()) {
+            scriptPath = arg;
+        } else {
+            PrintUsage(argv[0]);
+            return 2;
+        }
+    }
+
+    ActionEntries entries;
+    for (const auto &path: actionFiles) {
+        if (!LoadActions(path, entries)) {
+            return 2;
+        }
+    }
+    GenerateActions(generateCount, entries);
+
+    hotline::ActionSet actions;
+    actions.SetTypoTolerance(typos);
+    const auto loadStart = std::chrono::steady_clock::now();
+    actions.AddActions(entries);
+    if (printTime) {
+        const auto loadTime = std::chrono::steady_clock::now() - loadStart;
+        std::printf("%zu actions added in %lld ms\n", actions.GetActionCount(),
+                    static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(loadTime).count()));
+    }
+
+    std::ifstream script;
+    if (!scriptPath.empty()) {
+        script.open(scriptPath);
+        if (!script) {
+            std::fprintf(stderr, "can't open %s\n", scriptPath.c_str());
+            return 2;
+        }
+    }
+    std::istream &input = scriptPath.empty() ? std::cin : script;
+
+    if (queryMode) {
+        RunQueries(actions, input, limit, printTime);
+        return 0;
+    }
+    return RunCommands(actions, input, scriptPath.empty() ? "stdin" : scriptPath);
+}
@@ -0,0 +1,103 @@
+// sends commands to CommandServer and prints one "<status> <command>" line per command.
+// Exit code: 0 if all commands executed, 1 if some didn't, 2 if server can't be reached
+//   hotline_command_client /tmp/hotline.sock "ToggleX" "OneParFunction 5"
+//   hotline_command_client /tmp/hotline.sock < commands.txt
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+    bool SendAll(int fd, const std::string &data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            const ssize_t count = send(fd, data.data() + sent, data.size() - sent, 0);
+            if (count <= 0) {
+                return false;
+            }
+            sent += static_cast<size_t>(count);
+        }
+        return true;
+    }
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <socket> [command...]\n", argv[0]);
+        return 2;
+    }
+
+    // blank lines get no reply, so they are not sent
+    std::vector<std::string> commands;
+    if (argc > 2) {
+        commands.assign(argv + 2, argv + argc);
+    } else {
+        for (std::string line; std::getline(std::cin, line);) {
+            commands.push_back(std::move(line));
+        }
+    }
+    std::string request;
+    std::vector<const std::string *> sentCommands;
+    for (const auto &command: commands) {
+        if (command.find_first_not_of(" \r") != std::string::npos) {
+            request += command;
+            request += '\n';
+            sentCommands.push_back(&command);
+        }
+    }
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    const std::string path = argv[1];
+    if (path.size() >= sizeof(address.sun_path)) {
+        std::fprintf(stderr, "socket path is too long: %s\n", path.c_str());
+        return 2;
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0) {
+        std::fprintf(stderr, "can't connect to %s: %s\n", path.c_str(), std::strerror(errno));
+        return 2;
+    }
+
+    // server buffers replies, so whole batch is sent before reading them
+    if (!SendAll(fd, request) || shutdown(fd, SHUT_WR) != 0) {
+        std::fprintf(stderr, "sending failed: %s\n", std::strerror(errno));
+        close(fd);
+        return 2;
+    }
+
+    std::string replies;
+    char buffer[16 * 1024];
+    for (;;) {
+        const ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+        if (received <= 0) {
+            break;
+        }
+        replies.append(buffer, static_cast<size_t>(received));
+    }
+    close(fd);
+
+    int result = 0;
+    size_t replyStart = 0;
+    for (const std::string *command: sentCommands) {
+        const size_t end = replies.find('\n', replyStart);
+        if (end == std::string::npos) {
+            std::printf("no-reply %s\n", command->c_str());
+            result = 1;
+            continue;
+        }
+        const std::string status = replies.substr(replyStart, end - replyStart);
+        replyStart = end + 1;
+        std::printf("%s %s\n", status.c_str(), command->c_str());
+        if (status != "ok") {
+            result = 1;
+        }
+    }
+    return result;
+}
@@ -0,0 +1,74 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ActionSet.h"
+#include "ActionSetGroup.h"
+#include "Check.h"
+
+using namespace hotline;
+
+namespace {
+    void TestMergeOrder() {
+        auto editor = std::make_shared<ActionSet>();
+        editor->AddAction("AutoSaveVersions", []() {});
+        editor->AddAction("Save", []() {});
+        auto scene = std::make_shared<ActionSet>();
+        scene->AddAction("Save", []() {});
+        scene->AddAction("SaveSelection", []() {});
+
+        ActionSetGroup group;
+        CHECK(group.AddActionSet("editor", editor) == 0);
+        CHECK(group.AddActionSet("scene", scene) == 1);
+
+        // ranked together, equal variants keep scope order
+        const std::vector<ActionVariant> variants = group.FindVariants("Save", 10);
+        CHECK(variants.size() == 4);
+        if (variants.size() == 4) {
+            CHECK(variants[0].actionName == "Save" && variants[0].scope == 0);
+            CHECK(variants[1].actionName == "Save" && variants[1].scope == 1);
+            CHECK(variants[2].actionName == "SaveSelection" && variants[2].scope == 1);
+            CHECK(variants[3].actionName == "AutoSaveVersions" && variants[3].scope == 0);
+        }
+
+        // best `limit` over all sets, not first `limit` of first set
+        VariantResults results;
+        group.FindVariants("Save", 3, results);
+        CHECK(results.Size() == 3);
+        CHECK(results.Size() == 3 && group.GetVariantName(results[2], results) == "SaveSelection");
+    }
+
+    void TestDisabledSet() {
+        auto editor = std::make_shared<ActionSet>();
+        editor->AddAction("OpenScene", []() {});
+        auto tools = std::make_shared<ActionSet>();
+        int toolRuns = 0;
+        tools->AddAction("OpenProfiler", [&toolRuns]() { toolRuns++; });
+
+        ActionSetGroup group;
+        group.AddActionSet("editor", editor);
+        const size_t toolsScope = group.AddActionSet("tools", tools, false);
+        CHECK(!group.IsActionSetEnabled("tools"));
+        CHECK(group.GetActionSet("tools") == tools);
+
+        std::vector<ActionVariant> variants = group.FindVariants("Open", 10);
+        CHECK(variants.size() == 1 && variants.front().actionName == "OpenScene");
+        ActionVariant exact;
+        CHECK(!group.FindExactVariant("OpenProfiler", exact));
+
+        group.SetActionSetEnabled("tools", true);
+        variants = group.FindVariants("Open", 10);
+        CHECK(variants.size() == 2);
+        CHECK(group.FindExactVariant("openprofiler", exact) && exact.scope == toolsScope);
+
+        // executed in first enabled set which has the action
+        group.ExecuteAction("OpenProfiler", {});
+        CHECK(toolRuns == 1);
+    }
+}
+
+int main() {
+    TestMergeOrder();
+    TestDisabledSet();
+    return CHECK_RESULT();
+}
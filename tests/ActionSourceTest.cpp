@@ -0,0 +1,103 @@
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ActionSet.h"
+#include "ActionSource.h"
+#include "Check.h"
+
+using namespace hotline;
+
+namespace {
+    std::shared_ptr<CachedActionSource> MakeSource(std::vector<std::string> names, std::vector<std::string> &executed,
+                                                   int &collections) {
+        return std::make_shared<CachedActionSource>(
+                [names, &collections](std::vector<std::string> &out) {
+                    collections++;
+                    out = names;
+                },
+                [&executed](const std::string &name, const std::vector<std::string> &) { executed.push_back(name); });
+    }
+
+    void TestNamedVariants() {
+        // registered actions and source actions are ranked together and come back with names
+        std::vector<std::string> executed;
+        int collections = 0;
+        ActionSetFunc set;
+        int opened = 0;
+        set.AddAction("OpenScene", [&]() { opened++; });
+        set.AddAction("CloseScene", []() {});
+        set.AddSource(MakeSource({"Scenes/Forest.scene", "Scenes/Desert.scene", "Textures/Rock.png"}, executed,
+                                 collections));
+        CHECK(collections == 0);
+
+        const std::vector<ActionVariant> found = set.FindVariants("scene");
+        CHECK(collections == 1);
+        CHECK(found.size() == 4);
+        std::vector<std::string> names;
+        for (const auto &variant: found) {
+            names.push_back(variant.actionName);
+            CHECK(!variant.positions.empty());
+            CHECK(variant.actionArguments.empty());
+        }
+        CHECK(std::find(names.begin(), names.end(), "OpenScene") != names.end());
+        CHECK(std::find(names.begin(), names.end(), "Scenes/Desert.scene") != names.end());
+        CHECK(std::find(names.begin(), names.end(), "Textures/Rock.png") == names.end());
+
+        // cached until invalidated
+        set.FindVariants("rock");
+        CHECK(collections == 1);
+
+        set.ExecuteAction("Scenes/Forest.scene");
+        set.ExecuteAction("OpenScene");
+        CHECK(executed == std::vector<std::string>({"Scenes/Forest.scene"}));
+        CHECK(opened == 1);
+    }
+
+    void TestExactAndAlias() {
+        std::vector<std::string> executed;
+        int collections = 0;
+        ActionSetFunc set;
+        set.AddAction("ReloadShaders", []() {});
+        CHECK(set.AddActionAlias("ReloadShaders", "rs"));
+        set.AddSource(MakeSource({"reloadshaders", "ReloadShadersAsync"}, executed, collections));
+
+        std::vector<ActionVariant> found = set.FindVariants("rs");
+        CHECK(!found.empty() && found.front().actionName == "ReloadShaders");
+        CHECK(!found.empty() && found.front().kind == MatchKind::Exact);
+
+        // source action of the same name as exact hit isn't listed twice
+        found = set.FindVariants("ReloadShaders");
+        CHECK(found.size() == 2);
+        CHECK(!found.empty() && found.front().actionName == "ReloadShaders");
+        CHECK(found.size() == 2 && found[1].actionName == "ReloadShadersAsync");
+    }
+
+    void TestStreamingSource() {
+        // generator sees query of every search, nothing is kept
+        std::vector<std::string> queries;
+        auto source = std::make_shared<StreamingActionSource>(
+                [&](const SourceQuery &query, const CandidateSink &sink) {
+                    queries.emplace_back(query.query);
+                    sink("Entity 17", "", 0);
+                    sink("Entity 42", "", 0);
+                },
+                [](const std::string &name, const std::vector<std::string> &) { return name == "Entity 42"; });
+        ActionSetFunc set;
+        set.AddSource(source);
+        const std::vector<ActionVariant> found = set.FindVariants("ent 42");
+        CHECK(queries == std::vector<std::string>({"ent 42"}));
+        CHECK(found.size() == 1 && found.front().actionName == "Entity 42");
+        // filtered queries skip sources, they have no categories or tags
+        CHECK(set.FindVariants("@tools ent").empty());
+        CHECK(queries.size() == 1);
+    }
+}
+
+int main() {
+    TestNamedVariants();
+    TestExactAndAlias();
+    TestStreamingSource();
+    return CHECK_RESULT();
+}
@@ -0,0 +1,101 @@
+#include <cstdlib>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Action.h"
+#include "ActionSet.h"
+#include "Check.h"
+
+using namespace hotline;
+
+namespace {
+    // headless argument provider, same members Action uses of ArgProviderBase
+    template<typename T>
+    struct TestArg {
+        std::string _name;
+        T _arg{};
+        bool _provided = false;
+
+        explicit TestArg(std::string name) : _name(std::move(name)) {}
+
+        ArgumentProvidingState Provide() { return _provided ? Provided : InProgress; }
+        void Reset() { _provided = false; }
+        const PrefixIndex *GetValueIndex() { return nullptr; }
+
+        bool ProvideFromString(const std::string &str) {
+            if constexpr (std::is_same_v<T, int>) {
+                char *end = nullptr;
+                const long value = std::strtol(str.c_str(), &end, 10);
+                if (str.empty() || *end != '\0') {
+                    return false;
+                }
+                _arg = static_cast<int>(value);
+            } else {
+                _arg = str;
+            }
+            _provided = true;
+            return true;
+        }
+
+        operator T() const { return _arg; }
+    };
+
+    void TestStart() {
+        int scaled = 0;
+        auto action = MakeAction("Scale", [&scaled](int factor) { scaled = factor; }, TestArg<int>("Factor"));
+        CHECK(action->GetName() == "Scale");
+        CHECK(action->GetArguments().size() == 1 && action->GetArguments()[0] == "Factor");
+
+        CHECK(action->Start({"3"}) == ActionStartResult::Success);
+        CHECK(scaled == 3);
+        // unparsable argument doesn't run the action
+        CHECK(action->Start({"three"}) == ActionStartResult::InvalidArguments);
+        CHECK(scaled == 3);
+        // missing arguments are left to provider frontend
+        CHECK(action->Start({}) == ActionStartResult::Failure);
+        CHECK(scaled == 3);
+    }
+
+    void TestCommandStatus() {
+        ActionSet set;
+        int moved = 0;
+        set.AddAction("Move", [&moved](int x, int y) { moved = x * 10 + y; },
+                      TestArg<int>("X"), TestArg<int>("Y"));
+
+        CHECK(set.ExecuteCommand("Move 1 2") == CommandStatus::Executed);
+        CHECK(moved == 12);
+        CHECK(set.ExecuteCommand("Move 1 y") == CommandStatus::InvalidArguments);
+        CHECK(set.ExecuteCommand("Move 1") == CommandStatus::MissingArguments);
+        CHECK(moved == 12);
+        CHECK(set.ExecuteCommand("Jump 1") == CommandStatus::UnknownAction);
+        // command doesn't leave the set waiting for provider frontend
+        CHECK(set.GetState() == None);
+        CHECK(set.ExecuteCommand("Move 3 4") == CommandStatus::Executed);
+        CHECK(moved == 34);
+    }
+
+    void TestQuotedArguments() {
+        ActionSet set;
+        std::string renamed;
+        set.AddAction("Rename", [&renamed](const std::string &name) { renamed = name; },
+                      TestArg<std::string>("Name"));
+
+        CHECK(set.ExecuteCommand("Rename \"New Scene\"") == CommandStatus::Executed);
+        CHECK(renamed == "New Scene");
+        CHECK(set.ExecuteCommand("Rename 'it''s'") == CommandStatus::Executed);
+        CHECK(renamed == "its");
+        CHECK(set.ExecuteCommand("Rename \"say \\\"hi\\\"\"") == CommandStatus::Executed);
+        CHECK(renamed == "say \"hi\"");
+        set.ExecuteAction("Rename \t \"tabbed name\"");
+        CHECK(renamed == "tabbed name");
+    }
+}
+
+int main() {
+    TestStart();
+    TestCommandStatus();
+    TestQuotedArguments();
+    return CHECK_RESULT();
+}
@@ -0,0 +1,44 @@
+#include <string>
+#include <vector>
+
+#include "Action.h"
+#include "ArgProvider.h"
+#include "Check.h"
+
+// provider state only, no ImGui context is created and nothing is drawn
+namespace {
+    void TestPresetLabels() {
+        ArgProvider<int> provider("Count");
+        CHECK(provider._customChildId == "Count_custom");
+        CHECK(provider._presetLabelsDirty);
+
+        provider.RefreshPresetLabels();
+        CHECK(!provider._presetLabelsDirty);
+        CHECK(provider._presetLabels.size() == 2);
+        CHECK(provider._presetLabels[0][0] == "1##0_0");
+        CHECK(provider._presetLabels[1][3] == "-10000##1_3");
+
+        // equal values in different cells still get unique ids
+        provider.SetPresets({{5, 5}, {5}});
+        CHECK(provider._presetLabelsDirty);
+        provider.RefreshPresetLabels();
+        CHECK(provider._presetLabels.size() == 2);
+        CHECK(provider._presetLabels[0].size() == 2 && provider._presetLabels[1].size() == 1);
+        CHECK(provider._presetLabels[0][0] == "5##0_0");
+        CHECK(provider._presetLabels[0][1] == "5##0_1");
+        CHECK(provider._presetLabels[1][0] == "5##1_0");
+    }
+
+    void TestStringPresetLabels() {
+        ArgProvider<std::string> provider("Name", {{"alpha", "beta"}});
+        provider.RefreshPresetLabels();
+        CHECK(provider._presetLabels.size() == 1);
+        CHECK(provider._presetLabels[0][1] == "beta##0_1");
+    }
+}
+
+int main() {
+    TestPresetLabels();
+    TestStringPresetLabels();
+    return CHECK_RESULT();
+}
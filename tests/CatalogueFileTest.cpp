@@ -0,0 +1,152 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ActionSet.h"
+#include "ActionSource.h"
+#include "Check.h"
+#include "search/CatalogueFile.h"
+
+using namespace hotline;
+
+namespace {
+    std::string TempPath(const char *name) {
+        return (std::filesystem::temp_directory_path() / name).string();
+    }
+
+    std::vector<char> ReadFile(const std::string &path) {
+        std::ifstream in(path, std::ios::binary);
+        return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    }
+
+    // copy of catalogue with 32-bit value written at offset, size changed if given
+    std::string WritePatched(const std::vector<char> &data, size_t offset, uint32_t value, size_t size = 0) {
+        std::vector<char> patched = data;
+        std::memcpy(patched.data() + offset, &value, sizeof(value));
+        if (size > 0) {
+            patched.resize(size);
+        }
+        const std::string path = TempPath("hotline_catalogue_patched.bin");
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(patched.data(), static_cast<std::streamsize>(patched.size()));
+        return path;
+    }
+
+    bool OpensPatched(const std::vector<char> &data, size_t offset, uint32_t value, size_t size = 0) {
+        const std::string path = WritePatched(data, offset, value, size);
+        MappedCatalogue catalogue;
+        const bool opened = catalogue.Open(path);
+        catalogue.Close();
+        std::filesystem::remove(path);
+        return opened;
+    }
+
+    // broken entry opens, but reads as empty and isn't streamed by source
+    bool SkipsPatchedEntry(const std::vector<char> &data, size_t offset, uint32_t value, size_t entry) {
+        const std::string path = WritePatched(data, offset, value);
+        bool skipped = false;
+        {
+            MappedCatalogueSource source(path, nullptr);
+            size_t streamed = 0;
+            source.Enumerate({}, [&streamed](std::string_view, std::string_view, uint64_t) { streamed++; });
+            MappedCatalogue catalogue;
+            skipped = source.IsOpen() && catalogue.Open(path) && !catalogue.IsValid(entry)
+                      && catalogue.GetName(entry).empty() && catalogue.GetLowerName(entry).empty()
+                      && streamed == catalogue.Size() - 1;
+        }
+        std::filesystem::remove(path);
+        return skipped;
+    }
+
+    void TestRoundTrip(const std::string &path) {
+        MappedCatalogue catalogue;
+        CHECK(catalogue.Open(path));
+        CHECK(catalogue.Size() == 1000);
+        const size_t found = catalogue.Find("Asset Item 42");
+        CHECK(found != MappedCatalogue::npos);
+        if (found != MappedCatalogue::npos) {
+            CHECK(catalogue.GetName(found) == "Asset Item 42");
+            CHECK(catalogue.GetLowerName(found) == "asset item 42");
+        }
+        CHECK(catalogue.Find("Asset Item 1000") == MappedCatalogue::npos);
+        CHECK(!catalogue.Open(TempPath("hotline_catalogue_missing.bin")));
+        CHECK(!catalogue.IsOpen());
+    }
+
+    void TestValidation(const std::string &path) {
+        const std::vector<char> data = ReadFile(path);
+        CatalogueHeader header{};
+        std::memcpy(&header, data.data(), sizeof(header));
+        const auto strings = static_cast<uint32_t>(header.stringsSize);
+        const auto entryField = [&](size_t entry, size_t field) {
+            return header.entriesOffset + entry * sizeof(CatalogueEntry) + field;
+        };
+
+        CHECK(OpensPatched(data, entryField(3, offsetof(CatalogueEntry, nameSize)), 1));
+        CHECK(!OpensPatched(data, offsetof(CatalogueHeader, formatVersion), catalogueFormatVersion + 1));
+        CHECK(!OpensPatched(data, 0, 0, data.size() - 1));
+        CHECK(!OpensPatched(data, offsetof(CatalogueHeader, stringsOffset), 0xFFFFFFF0u));
+        CHECK(!OpensPatched(data, offsetof(CatalogueHeader, entriesOffset), 0));
+        // entries are checked when read, not on open
+        CHECK(SkipsPatchedEntry(data, entryField(999, offsetof(CatalogueEntry, nameOffset)), strings, 999));
+        CHECK(SkipsPatchedEntry(data, entryField(3, offsetof(CatalogueEntry, nameSize)), strings + 1, 3));
+        CHECK(SkipsPatchedEntry(data, entryField(7, offsetof(CatalogueEntry, lowerSize)), 0xFFFFFFFFu, 7));
+        CHECK(SkipsPatchedEntry(data, entryField(7, offsetof(CatalogueEntry, lowerOffset)), 0xFFFFFFF0u, 7));
+
+        // index values out of range are skipped by lookup
+        const std::string patched = WritePatched(data, header.sortedOffset + 10 * sizeof(uint32_t), 1000);
+        {
+            MappedCatalogue catalogue;
+            CHECK(catalogue.Open(patched));
+            for (size_t i = 0; i < catalogue.Size(); i++) {
+                catalogue.Find(catalogue.GetName(i));
+            }
+            CHECK(catalogue.Find("Asset Item 42") != MappedCatalogue::npos);
+        }
+        std::filesystem::remove(patched);
+    }
+
+    void TestSteppedSearch(const std::string &path) {
+        // resumable search continues inside the source instead of scanning it whole in one step
+        auto source = std::make_shared<MappedCatalogueSource>(path, nullptr);
+        CHECK(source->IsOpen());
+        ActionSetFuncPar set;
+        set.AddSource(source);
+
+        VariantResults results;
+        int steps = 0;
+        bool done = false;
+        while (!done && steps < 10000) {
+            SearchBudget budget(100, std::chrono::microseconds(0));
+            done = set.FindVariantsStep("item 999", 5, budget, results);
+            steps++;
+        }
+        CHECK(done);
+        CHECK(steps >= 5);
+        const std::vector<ActionVariant> all = set.FindVariants("item 999", 5);
+        CHECK(results.Size() == all.size());
+        CHECK(!all.empty() && set.GetVariantName(results[0], results) == all.front().actionName);
+    }
+}
+
+int main() {
+    ActionSetFuncPar set;
+    for (int i = 0; i < 1000; i++) {
+        set.AddAction("Asset Item " + std::to_string(i), []() {});
+    }
+    const std::string path = TempPath("hotline_catalogue_test.bin");
+    CHECK(set.SaveCatalogue(path));
+
+    TestRoundTrip(path);
+    TestValidation(path);
+    TestSteppedSearch(path);
+    std::filesystem::remove(path);
+    return CHECK_RESULT();
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdio>
+
+// checks of hotline_core tests. Unlike assert they stay in release builds and don't stop at first failure,
+// test executable returns CHECK_RESULT() from main so ctest reports it
+namespace hotline::test {
+    inline int &FailureCount() {
+        static int failures = 0;
+        return failures;
+    }
+}
+
+#define CHECK(condition)                                                                            \
+    do {                                                                                            \
+        if (!(condition)) {                                                                         \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition);      \
+            hotline::test::FailureCount()++;                                                        \
+        }                                                                                           \
+    } while (0)
+
+#define CHECK_RESULT() (hotline::test::FailureCount() == 0 ? 0 : 1)
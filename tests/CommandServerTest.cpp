@@ -0,0 +1,190 @@
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+#include "ActionSetGroup.h"
+#include "Check.h"
+#include "CommandServer.h"
+
+using namespace hotline;
+
+namespace {
+    // records arguments of every start. Needs one argument, "bad" is rejected
+    class RecordingAction : public BaseAction {
+    public:
+        RecordingAction(const std::string &name, std::vector<std::vector<std::string>> &calls)
+                : _name(SharedStringPool().Intern(name)), _labels{SharedStringPool().Intern("value")},
+                  _calls(calls) {}
+
+        ~RecordingAction() override {
+            SharedStringPool().Release(_name);
+            SharedStringPool().Release(_labels.front());
+        }
+
+        ArgumentProvidingState UpdateProviding() override { return Cancelled; }
+
+        ActionStartResult Start(const std::vector<std::string> &stringArgs) override {
+            if (stringArgs.empty()) {
+                return ActionStartResult::Failure;
+            }
+            if (stringArgs.front() == "bad") {
+                return ActionStartResult::InvalidArguments;
+            }
+            _calls.push_back(stringArgs);
+            return ActionStartResult::Success;
+        }
+
+        std::string_view GetName() const override { return _name; }
+        const std::vector<std::string_view> &GetArguments() const override { return _labels; }
+        const PrefixIndex *GetArgumentValueIndex(size_t) override { return nullptr; }
+
+    private:
+        std::string_view _name;
+        std::vector<std::string_view> _labels;
+        std::vector<std::vector<std::string>> &_calls;
+    };
+
+    int Connect(const std::string &path) {
+        const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+        if (fd >= 0 && connect(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0) {
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    // polls server until client got replyCount lines or server closed connection
+    std::string Exchange(CommandServer &server, int fd, const std::string &input, size_t replyCount,
+                         bool finish = true) {
+        CHECK(send(fd, input.data(), input.size(), 0) == static_cast<ssize_t>(input.size()));
+        if (finish) {
+            shutdown(fd, SHUT_WR);
+        }
+        std::string replies;
+        char buffer[256];
+        for (int i = 0; i < 1000; i++) {
+            server.Poll();
+            const ssize_t received = recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+            if (received > 0) {
+                replies.append(buffer, static_cast<size_t>(received));
+            } else if (received == 0) {
+                break;
+            }
+            size_t lines = 0;
+            for (const char c: replies) {
+                lines += c == '\n';
+            }
+            if (lines >= replyCount) {
+                break;
+            }
+            usleep(1000);
+        }
+        return replies;
+    }
+
+    void TestCommands(CommandServer &server, const std::string &path,
+                      const std::vector<std::vector<std::string>> &calls) {
+        const int fd = Connect(path);
+        CHECK(fd >= 0);
+        // blank lines get no reply, \r\n ends line too and last line may miss its newline
+        const std::string replies = Exchange(server, fd,
+                                             "Record one\n"
+                                             "   \n"
+                                             "Missing\n"
+                                             "Record \"two words\" 'x y'\r\n"
+                                             "Record\n"
+                                             "Record bad\n"
+                                             "Hidden 1\n"
+                                             "Record\t\"quote \\\" inside\"", 6);
+        CHECK(replies == "ok\nunknown\nok\nmissing-arguments\ninvalid-arguments\nunavailable\nok\n");
+        CHECK(calls.size() == 3);
+        if (calls.size() == 3) {
+            CHECK(calls[0] == std::vector<std::string>({"one"}));
+            CHECK(calls[1] == std::vector<std::string>({"two words", "x y"}));
+            CHECK(calls[2] == std::vector<std::string>({"quote \" inside"}));
+        }
+        close(fd);
+    }
+
+    void TestCommandLimit(CommandServer &server, const std::string &path) {
+        const int fd = Connect(path);
+        std::string input;
+        for (int i = 0; i < 10; i++) {
+            input += "Record " + std::to_string(i) + "\n";
+        }
+        CHECK(send(fd, input.data(), input.size(), 0) == static_cast<ssize_t>(input.size()));
+        size_t executed = 0;
+        for (int i = 0; i < 1000 && executed == 0; i++) {
+            executed = server.Poll(4);
+            usleep(1000);
+        }
+        CHECK(executed == 4);
+        std::string expected;
+        for (int i = 0; i < 10; i++) {
+            expected += "ok\n";
+        }
+        // rest is executed by next polls
+        CHECK(Exchange(server, fd, "", 10) == expected);
+        close(fd);
+    }
+
+    void TestEndlessLine(CommandServer &server, const std::string &path) {
+        // client sending a line longer than any command is dropped, server keeps serving others
+        const int fd = Connect(path);
+        const std::string endless(70 * 1024, 'a');
+        CHECK(Exchange(server, fd, endless, 1, false).empty());
+        char byte;
+        CHECK(recv(fd, &byte, 1, MSG_DONTWAIT) == 0);
+        close(fd);
+
+        const int other = Connect(path);
+        CHECK(Exchange(server, other, "Record again\n", 1) == "ok\n");
+        close(other);
+    }
+
+    void TestStart(CommandServer &server, const std::string &path, ActionSetGroup &sets) {
+        // path of running server is not taken over, file of stopped one is
+        CommandServer second(sets);
+        CHECK(!second.Start(path));
+        CHECK(server.IsRunning());
+        CHECK(!second.Start(std::string(200, 'p')));
+        server.Stop();
+        CHECK(!std::filesystem::exists(path));
+        CHECK(server.Start(path));
+    }
+}
+
+int main() {
+    std::vector<std::vector<std::string>> calls;
+    auto set = std::make_shared<ActionSet>();
+    std::vector<std::pair<std::string, std::unique_ptr<BaseAction>>> actions;
+    actions.emplace_back("Record", std::make_unique<RecordingAction>("Record", calls));
+    actions.emplace_back("Hidden", std::make_unique<RecordingAction>("Hidden", calls));
+    set->AddActions(actions);
+    set->SetActionRequirements("Hidden", {"never"});
+    ActionSetGroup sets;
+    sets.AddActionSet("test", set);
+
+    const std::string path = (std::filesystem::temp_directory_path() /
+                              ("hotline_test_" + std::to_string(getpid()) + ".sock")).string();
+    CommandServer server(sets);
+    CHECK(server.Start(path));
+    CHECK(CommandServer::GetStatusText(CommandStatus::Busy) == std::string("busy"));
+
+    TestCommands(server, path, calls);
+    TestCommandLimit(server, path);
+    TestEndlessLine(server, path);
+    TestStart(server, path, sets);
+    server.Stop();
+    return CHECK_RESULT();
+}
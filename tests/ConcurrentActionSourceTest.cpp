@@ -0,0 +1,107 @@
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ActionSource.h"
+#include "Check.h"
+
+using namespace hotline;
+
+namespace {
+    size_t CountNames(ConcurrentActionSource &source) {
+        size_t count = 0;
+        source.Enumerate({}, [&](std::string_view, std::string_view, uint64_t) { count++; });
+        return count;
+    }
+
+    void TestAddRemove() {
+        std::vector<std::string> executed;
+        ConcurrentActionSource source([&](const std::string &name, const std::vector<std::string> &) {
+            executed.push_back(name);
+        });
+        CHECK(source.Size() == 0);
+
+        source.AddActions({"LoadLevel", "SaveLevel"});
+        source.AddActions({"SaveLevel", "BakeLighting"});    // published name is skipped
+        CHECK(source.Size() == 3);
+        CHECK(CountNames(source) == 3);
+
+        source.RemoveActions({"SaveLevel", "Unknown"});
+        CHECK(source.Size() == 2);
+        CHECK(!source.ExecuteAction("SaveLevel", {}));
+        CHECK(source.ExecuteAction("BakeLighting", {}));
+        CHECK(executed == std::vector<std::string>({"BakeLighting"}));
+
+        // removed name can be added again
+        source.AddActions({"SaveLevel"});
+        CHECK(source.Size() == 3);
+    }
+
+    void TestSegmentsMerged() {
+        ConcurrentActionSource source(nullptr);
+        for (int i = 0; i < 1000; i++) {
+            source.AddActions({"Asset" + std::to_string(i)});
+        }
+        CHECK(source.Size() == 1000);
+        // sizes of segments at least halve from oldest to newest
+        CHECK(source.GetSegmentCount() <= 11);
+        CHECK(CountNames(source) == 1000);
+    }
+
+    void TestPinnedVersion() {
+        // search keeps version it started with, names published meanwhile show up in next search
+        ConcurrentActionSource source(nullptr);
+        source.AddActions({"First", "Second"});
+        const uint64_t version = source.GetVersion();
+        size_t seen = 0;
+        source.Enumerate({}, [&](std::string_view, std::string_view, uint64_t) {
+            if (seen++ == 0) {
+                source.AddActions({"Third"});
+                source.RemoveActions({"First", "Second"});
+            }
+        });
+        CHECK(seen == 2);
+        CHECK(source.GetVersion() == version + 2);
+        CHECK(CountNames(source) == 1);
+    }
+
+    void TestConcurrentReaders() {
+        // every search sees a whole published version: names are added in batches of 10
+        ConcurrentActionSource source(nullptr);
+        std::atomic<bool> done{false};
+        std::atomic<int> partialVersions{0};
+        std::vector<std::thread> readers;
+        for (int i = 0; i < 3; i++) {
+            readers.emplace_back([&]() {
+                while (!done.load()) {
+                    if (CountNames(source) % 10 != 0) {
+                        partialVersions++;
+                    }
+                }
+            });
+        }
+        for (int batch = 0; batch < 200; batch++) {
+            std::vector<std::string> names;
+            for (int i = 0; i < 10; i++) {
+                names.push_back("Mesh" + std::to_string(batch * 10 + i));
+            }
+            source.AddActions(names);
+        }
+        done = true;
+        for (auto &reader: readers) {
+            reader.join();
+        }
+        CHECK(partialVersions == 0);
+        CHECK(source.Size() == 2000);
+        CHECK(CountNames(source) == 2000);
+    }
+}
+
+int main() {
+    TestAddRemove();
+    TestSegmentsMerged();
+    TestPinnedVersion();
+    TestConcurrentReaders();
+    return CHECK_RESULT();
+}
@@ -0,0 +1,101 @@
+#include <string>
+#include <vector>
+
+#include "ActionSet.h"
+#include "Check.h"
+
+using namespace hotline;
+
+namespace {
+    bool Finds(ActionSet &set, const std::string &query, const std::string &name) {
+        for (const ActionVariant &variant: set.FindVariants(query)) {
+            if (variant.actionName == name) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void TestRequirements() {
+        ActionSet set;
+        int deletes = 0;
+        set.AddAction("DeleteSelection", [&deletes]() { deletes++; });
+        set.AddAction("Paste", []() {});
+        set.SetActionRequirements("DeleteSelection", {"selection"}, {"playing"});
+        set.SetActionRequirements("Paste", {}, {"playing"});
+
+        CHECK(!set.IsActionAvailable("DeleteSelection"));
+        CHECK(set.IsActionAvailable("Paste"));
+        CHECK(!Finds(set, "delete", "DeleteSelection"));
+        ActionVariant exact;
+        CHECK(!set.FindExactVariant("DeleteSelection", exact));
+        CHECK(set.ExecuteCommand("DeleteSelection") == CommandStatus::Unavailable);
+        CHECK(deletes == 0);
+
+        set.SetContextFlag("selection", true);
+        CHECK(set.GetContextFlag("selection"));
+        CHECK(set.IsActionAvailable("DeleteSelection"));
+        CHECK(Finds(set, "delete", "DeleteSelection"));
+        CHECK(set.ExecuteCommand("DeleteSelection") == CommandStatus::Executed);
+        CHECK(deletes == 1);
+
+        // forbidden flag hides actions requiring nothing as well
+        set.SetContextFlag("playing", true);
+        CHECK(!set.IsActionAvailable("DeleteSelection"));
+        CHECK(!set.IsActionAvailable("Paste"));
+        CHECK(set.FindVariants("paste").empty());
+        set.SetContextFlag("playing", false);
+        CHECK(set.IsActionAvailable("Paste"));
+    }
+
+    void TestInvalidation() {
+        ActionSet set;
+        set.AddAction("FocusSelection", []() {});
+        set.SetActionRequirements("FocusSelection", {"selection"});
+
+        // availability and results are recomputed only when a flag value changes
+        const uint64_t revision = set.GetRevision();
+        set.SetContextFlag("selection", false);
+        CHECK(set.GetRevision() == revision);
+        set.SetContextFlag("selection", true);
+        CHECK(set.GetRevision() != revision);
+        CHECK(set.IsActionAvailable("FocusSelection"));
+
+        // actions added later get availability from current flags
+        set.AddAction("FrameSelection", []() {});
+        set.SetActionRequirements("FrameSelection", {"selection"});
+        CHECK(set.IsActionAvailable("FrameSelection"));
+        set.SetContextFlag("selection", false);
+        CHECK(!set.IsActionAvailable("FrameSelection"));
+
+        // requirements of removed action don't stick to action reusing its slot
+        set.RemoveAction("FrameSelection");
+        set.AddAction("NewScene", []() {});
+        CHECK(set.IsActionAvailable("NewScene"));
+        CHECK(Finds(set, "newscene", "NewScene"));
+    }
+
+    void TestManyFlags() {
+        // availability bits cover more than one 64-slot word
+        ActionSet set;
+        for (int i = 0; i < 130; i++) {
+            const std::string name = "Tool" + std::to_string(i);
+            set.AddAction(name, []() {});
+            set.SetActionRequirements(name, {i % 2 == 0 ? "even" : "odd"});
+        }
+        set.SetContextFlag("odd", true);
+        CHECK(!set.IsActionAvailable("Tool128"));
+        CHECK(set.IsActionAvailable("Tool129"));
+        set.SetContextFlag("even", true);
+        set.SetContextFlag("odd", false);
+        CHECK(set.IsActionAvailable("Tool128"));
+        CHECK(!set.IsActionAvailable("Tool129"));
+    }
+}
+
+int main() {
+    TestRequirements();
+    TestInvalidation();
+    TestManyFlags();
+    return CHECK_RESULT();
+}
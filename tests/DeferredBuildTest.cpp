@@ -0,0 +1,105 @@
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "ActionSet.h"
+#include "Check.h"
+#include "search/SearchIndex.h"
+
+using namespace hotline;
+
+namespace {
+    // false if build doesn't finish in time
+    bool WaitForIndex(SearchIndex &index) {
+        for (int i = 0; i < 10000 && !index.IsIndexReady(); i++) {
+            if (!index.AdoptDeferredBuild()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        return index.IsIndexReady();
+    }
+
+    void TestAdoption() {
+        SearchIndex index;
+        std::vector<SearchIndex::Slot> slots;
+        for (int i = 0; i < 1000; i++) {
+            slots.push_back(index.AddDeferred("ExportMesh" + std::to_string(i)));
+        }
+        CHECK(!index.IsIndexReady());
+        CHECK(!index.IsIndexed(slots[5]));
+        // deferred slot is still searchable by plain scan, lookups miss it
+        std::string scratch;
+        const SearchIndex::SlotView view = index.GetView(slots[5], scratch);
+        CHECK(view.lowerName == "exportmesh5");
+        CHECK(view.wordStarts == nullptr);
+        CHECK(index.FindExact("exportmesh5") == SearchIndex::noSlot);
+
+        index.StartDeferredBuild();
+        // changes while build runs: removed slot and slot reused by another name are not taken over
+        index.Remove(slots[5]);
+        const SearchIndex::Slot reused = index.Add("ImportTexture");
+        CHECK(reused == slots[5]);
+        index.Remove(slots[6]);
+
+        CHECK(WaitForIndex(index));
+        CHECK(index.GetBuildProgress() == 1.0f);
+        CHECK(index.IsIndexed(slots[7]));
+        CHECK(index.FindExact("exportmesh7") == slots[7]);
+        CHECK(index.GetLowerName(slots[7]) == "exportmesh7");
+        CHECK(index.FindExact("exportmesh5") == SearchIndex::noSlot);
+        CHECK(index.FindExact("exportmesh6") == SearchIndex::noSlot);
+        CHECK(index.FindExact("importtexture") == reused);
+        CHECK(index.GetLowerName(reused) == "importtexture");
+        const std::pmr::vector<SearchIndex::Slot> *acronym = index.FindAcronym("it");
+        CHECK(acronym && acronym->size() == 1 && acronym->front() == reused);
+        CHECK(index.GetAcronym(slots[7]) == "em7");
+    }
+
+    void TestDeferredDuringBuild() {
+        // slots deferred while build runs get the next build
+        SearchIndex index;
+        for (int i = 0; i < 100; i++) {
+            index.AddDeferred("Open" + std::to_string(i));
+        }
+        index.StartDeferredBuild();
+        const SearchIndex::Slot late = index.AddDeferred("CloseAll");
+        index.StartDeferredBuild();     // no-op while first build runs
+        CHECK(WaitForIndex(index));
+        CHECK(index.FindExact("closeall") == late);
+        CHECK(index.FindExact("open99") != SearchIndex::noSlot);
+    }
+
+    void TestActionSet() {
+        ActionSetFuncPar set;
+        set.SetBackgroundIndexing(true);
+        std::vector<std::pair<std::string, std::unique_ptr<BaseAction>>> actions;
+        for (int i = 0; i < 2000; i++) {
+            const std::string name = "BakeLightmap" + std::to_string(i);
+            actions.emplace_back(name, MakeAction(name, []() {}));
+        }
+        set.AddActions(actions);
+
+        // same results before and after index is ready
+        const std::vector<ActionVariant> before = set.FindVariants("lightmap1999", 3);
+        for (int i = 0; i < 10000 && !set.IsIndexReady(); i++) {
+            set.UpdateIndexBuild();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        CHECK(set.IsIndexReady());
+        const std::vector<ActionVariant> after = set.FindVariants("lightmap1999", 3);
+        CHECK(!before.empty() && before.front().actionName == "BakeLightmap1999");
+        CHECK(before.size() == after.size());
+        CHECK(!after.empty() && after.front().actionName == before.front().actionName);
+        CHECK(!after.empty() && after.front().score == before.front().score);
+    }
+}
+
+int main() {
+    TestAdoption();
+    TestDeferredDuringBuild();
+    TestActionSet();
+    return CHECK_RESULT();
+}
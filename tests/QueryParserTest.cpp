@@ -0,0 +1,122 @@
+#include <string>
+#include <vector>
+
+#include "ActionSet.h"
+#include "Check.h"
+#include "search/FilterIndex.h"
+#include "search/FuzzyScorer.h"
+#include "search/QueryParser.h"
+
+using namespace hotline;
+
+namespace {
+    void TestTokens() {
+        ParsedQuery parsed;
+        ParseQuery("  Mesh   Export ", parsed);
+        CHECK(parsed.tokens.size() == 2);
+        CHECK(!parsed.IsSingleToken());
+        CHECK(parsed.filters.empty());
+        if (parsed.tokens.size() == 2) {
+            // longest first
+            CHECK(parsed.tokens[0].text == "Export");
+            CHECK(parsed.tokens[0].lower == "export");
+            CHECK(parsed.tokens[1].lower == "mesh");
+        }
+        CHECK(parsed.mask == FuzzyScorer::ComputeCharMask("meshexport"));
+
+        ParseQuery("shader", parsed);
+        CHECK(parsed.IsSingleToken());
+        CHECK(parsed.text == "shader");
+
+        ParseQuery("   ", parsed);
+        CHECK(parsed.IsEmpty());
+    }
+
+    void TestWordOrder() {
+        ActionSetFuncPar set;
+        set.AddAction("MeshExport", []() {});
+        set.AddAction("ExportScene", []() {});
+        set.AddAction("ImportMesh", []() {});
+
+        std::vector<ActionVariant> found = set.FindVariants("export mesh");
+        CHECK(found.size() == 1);
+        if (!found.empty()) {
+            CHECK(found.front().actionName == "MeshExport");
+            // positions of both words, ascending
+            CHECK(found.front().positions == std::vector<int>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+        }
+        CHECK(set.FindVariants("mesh export").size() == 1);
+
+        // every word has to match on its own
+        CHECK(set.FindVariants("export light").empty());
+        CHECK(set.FindVariants("mesh").size() == 2);
+    }
+
+    void TestFilterWords() {
+        ParsedQuery parsed;
+        ParseQuery("@Render shad #Debug", parsed);
+        CHECK(parsed.filters == std::vector<std::string>({"@render", "#debug"}));
+        CHECK(parsed.IsSingleToken());
+        CHECK(parsed.text == "shad");
+        CHECK(parsed.lower == "shad");
+        CHECK(parsed.filters.front() == FilterIndex::MakeCategoryKey("Render"));
+
+        // lone prefix is still being typed
+        ParseQuery("shad @", parsed);
+        CHECK(parsed.filters.empty());
+        CHECK(parsed.text == "shad");
+
+        ParseQuery("#debug", parsed);
+        CHECK(!parsed.IsEmpty());
+        CHECK(parsed.tokens.empty());
+    }
+
+    void TestFilterIndex() {
+        FilterIndex filters;
+        CHECK(filters.Find("#debug") == nullptr);
+        filters.Set("#debug", 130, true);
+        const FilterIndex::Bitmap *bitmap = filters.Find("#debug");
+        CHECK(bitmap && bitmap->size() == 3 && (*bitmap)[2] == uint64_t(1) << 2);
+        filters.Set("#debug", 130, false);
+        filters.Set("#debug", 500, false);
+        CHECK(bitmap->size() == 3 && (*bitmap)[2] == 0);
+    }
+
+    void TestFilteredSearch() {
+        ActionSetFuncPar set;
+        set.AddAction("ReloadShaders", []() {});
+        set.AddAction("CompileShader", []() {});
+        set.AddAction("ShowStats", []() {});
+        set.SetActionCategory("ReloadShaders", "Render");
+        set.SetActionCategory("CompileShader", "Build");
+        set.AddActionTag("ReloadShaders", "debug");
+        set.AddActionTag("ShowStats", "debug");
+
+        std::vector<ActionVariant> found = set.FindVariants("@render shad");
+        CHECK(found.size() == 1 && found.front().actionName == "ReloadShaders");
+        found = set.FindVariants("sh #debug");
+        CHECK(found.size() == 2);
+        CHECK(set.FindVariants("#debug").size() == 2);
+        CHECK(set.FindVariants("@render #debug").size() == 1);
+        CHECK(set.FindVariants("@audio shad").empty());
+
+        // category replaces previous one
+        set.SetActionCategory("CompileShader", "Render");
+        CHECK(set.FindVariants("@build").empty());
+        CHECK(set.FindVariants("@render shad").size() == 2);
+
+        // slot reused after removal doesn't keep filters of removed action
+        set.RemoveAction("ShowStats");
+        set.AddAction("ShowGrid", []() {});
+        CHECK(set.FindVariants("#debug").size() == 1);
+    }
+}
+
+int main() {
+    TestTokens();
+    TestWordOrder();
+    TestFilterWords();
+    TestFilterIndex();
+    TestFilteredSearch();
+    return CHECK_RESULT();
+}
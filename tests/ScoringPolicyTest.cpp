@@ -0,0 +1,91 @@
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ActionSet.h"
+#include "Check.h"
+#include "search/FuzzyScorer.h"
+#include "search/FuzzyScorerImpl.h"
+#include "search/Utf8.h"
+
+// own policies are instantiated in one source file, see BasicFuzzyScorer
+namespace {
+    struct SequenceScoring {
+        static constexpr bool runtimeWeights = false;
+        static constexpr hotline::ScoringWeights weights{1, 20, 0, 0, 0};
+    };
+
+    struct WordStartScoring {
+        static constexpr bool runtimeWeights = false;
+        static constexpr hotline::ScoringWeights weights{1, 0, 0, 0, 20};
+    };
+}
+
+template class hotline::BasicFuzzyScorer<SequenceScoring>;
+template class hotline::BasicFuzzyScorer<WordStartScoring>;
+
+using namespace hotline;
+
+namespace {
+    int Score(IFuzzyScorer &scorer, const std::string &query, const std::string &target) {
+        const std::string queryLower = ToLower(query);
+        const std::string targetLower = ToLower(target);
+        return scorer.GetScore(query, queryLower, static_cast<int>(query.size()), target, targetLower,
+                               static_cast<int>(target.size()));
+    }
+
+    void TestRuntimeMatchesConstant() {
+        // same weights give same scores, whether they are constants or runtime values
+        FuzzyScorer constant;
+        RuntimeFuzzyScorer runtime;
+        const std::vector<std::pair<std::string, std::string>> pairs = {
+                {"rs", "ReloadShaders"}, {"scn", "open_scene"}, {"Exp", "Export2D"}, {"\u00e9t", "\u00c9tat Table"},
+        };
+        for (const auto &[query, target]: pairs) {
+            const int score = Score(constant, query, target);
+            CHECK(score > 0);
+            CHECK(Score(runtime, query, target) == score);
+
+            // score without positions equals full fuzzy score
+            const std::string queryLower = ToLower(query);
+            const std::string targetLower = ToLower(target);
+            const FuzzyScore full = constant.GetFuzzyScore(query, queryLower, static_cast<int>(query.size()),
+                                                           target, targetLower, static_cast<int>(target.size()));
+            CHECK(full.score == score);
+            CHECK(full.positions.size() == 2 || full.positions.size() == 3);
+        }
+
+        // runtime weights apply from the next call
+        const int before = Score(runtime, "rs", "ReloadShaders");
+        runtime.GetPolicy().weights.nameStart = 0;
+        CHECK(Score(runtime, "rs", "ReloadShaders") < before);
+    }
+
+    void TestPolicyRanking() {
+        BasicFuzzyScorer<SequenceScoring> sequence;
+        BasicFuzzyScorer<WordStartScoring> wordStart;
+        CHECK(Score(sequence, "ab", "Cabin") > Score(sequence, "ab", "Alpha Beta Gamma"));
+        CHECK(Score(wordStart, "ab", "Cabin") < Score(wordStart, "ab", "Alpha Beta Gamma"));
+
+        // scorer of set decides order of results and starts a new search
+        ActionSetFunc set;
+        set.AddAction("Cabin", []() {});
+        set.AddAction("Alpha Beta Gamma", []() {});
+        set.SetScorer(std::make_unique<BasicFuzzyScorer<SequenceScoring>>());
+        std::vector<ActionVariant> variants = set.FindVariants("ab");
+        CHECK(variants.size() == 2 && variants.front().actionName == "Cabin");
+
+        const uint64_t revision = set.GetRevision();
+        set.SetScorer(std::make_unique<BasicFuzzyScorer<WordStartScoring>>());
+        CHECK(set.GetRevision() != revision);
+        variants = set.FindVariants("ab");
+        CHECK(variants.size() == 2 && variants.front().actionName == "Alpha Beta Gamma");
+    }
+}
+
+int main() {
+    TestRuntimeMatchesConstant();
+    TestPolicyRanking();
+    return CHECK_RESULT();
+}
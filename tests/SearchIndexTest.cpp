@@ -0,0 +1,151 @@
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ActionSet.h"
+#include "Check.h"
+#include "search/SearchIndex.h"
+#include "search/VariantResults.h"
+
+using namespace hotline;
+
+namespace {
+    void TestSlotReuse() {
+        SearchIndex index;
+        const SearchIndex::Slot open = index.Add("OpenScene");
+        const SearchIndex::Slot close = index.Add("CloseScene");
+        CHECK(index.Size() == 2);
+        CHECK(index.FindExact("openscene") == open);
+
+        const uint32_t generation = index.GetGeneration(open);
+        index.Remove(open);
+        CHECK(!index.IsAlive(open));
+        CHECK(index.Size() == 1);
+        CHECK(index.FreeSlotCount() == 1);
+        CHECK(index.FindExact("openscene") == SearchIndex::noSlot);
+
+        // removed slot is taken by next name, nothing of previous one is left
+        const SearchIndex::Slot reload = index.Add("ReloadShaders");
+        CHECK(reload == open);
+        CHECK(index.SlotCount() == 2);
+        CHECK(index.FreeSlotCount() == 0);
+        CHECK(index.GetName(reload) == "ReloadShaders");
+        CHECK(index.GetLowerName(reload) == "reloadshaders");
+        CHECK(index.FindExact("reloadshaders") == reload);
+        CHECK(index.FindExact("closescene") == close);
+        CHECK(!index.IsCurrent(reload, generation));
+        CHECK(index.IsCurrent(reload, index.GetGeneration(reload)));
+    }
+
+    void TestAliasesReleased() {
+        SearchIndex index;
+        const SearchIndex::Slot slot = index.Add("ToggleWireframe");
+        CHECK(index.AddAlias(slot, "wire"));
+        CHECK(!index.AddAlias(index.Add("ToggleGrid"), "Wire"));
+        CHECK(index.FindExact("wire") == slot);
+
+        index.Remove(slot);
+        CHECK(index.FindExact("wire") == SearchIndex::noSlot);
+        const SearchIndex::Slot reused = index.Add("ShowStats");
+        CHECK(reused == slot);
+        CHECK(index.GetAliases(reused).empty());
+        CHECK(index.AddAlias(reused, "wire"));
+    }
+
+    void TestNameWinsOverAlias() {
+        SearchIndex index;
+        const SearchIndex::Slot reload = index.Add("ReloadShaders");
+        CHECK(index.AddAlias(reload, "OpenScene"));
+        const SearchIndex::Slot open = index.Add(" OpenScene");
+        CHECK(index.FindExact("openscene") == open);
+        CHECK(index.FindExact("reloadshaders") == reload);
+
+        // alias gets its key back once the name is removed
+        index.Remove(open);
+        CHECK(index.FindExact("openscene") == reload);
+        index.Remove(reload);
+        CHECK(index.FindExact("openscene") == SearchIndex::noSlot);
+
+        ActionSetFunc set;
+        set.AddAction("Reload", []() {});
+        CHECK(set.AddActionAlias("Reload", "save"));
+        set.AddAction("Save", []() {});
+        ActionVariant variant;
+        CHECK(set.FindExactVariant("save", variant) && variant.actionName == "Save");
+    }
+
+    void TestExactKeyMovesOnRemove() {
+        SearchIndex index;
+        const SearchIndex::Slot first = index.Add("Openscene");
+        const SearchIndex::Slot second = index.Add("OpenScene");
+        CHECK(index.FindExact("openscene") == first);
+
+        index.Remove(first);
+        CHECK(index.FindExact("openscene") == second);
+        CHECK(index.GetName(index.FindExact("openscene")) == "OpenScene");
+
+        // removing hidden name keeps the key of its owner
+        const SearchIndex::Slot again = index.Add("OPENSCENE ");
+        index.Remove(again);
+        CHECK(index.FindExact("openscene") == second);
+        index.Remove(second);
+        CHECK(index.FindExact("openscene") == SearchIndex::noSlot);
+    }
+
+    void TestBulkRemoveAndAdd() {
+        ActionSetFuncPar set;
+        std::vector<std::pair<std::string, std::unique_ptr<BaseAction>>> actions;
+        for (int i = 0; i < 100; i++) {
+            const std::string name = "Action" + std::to_string(i);
+            actions.emplace_back(name, MakeAction(name, []() {}));
+        }
+        set.AddActions(actions);
+        CHECK(set.GetActionCount() == 100);
+
+        std::vector<std::string> removed;
+        for (int i = 0; i < 100; i += 2) {
+            removed.push_back("Action" + std::to_string(i));
+        }
+        set.RemoveActions(removed);
+        CHECK(set.GetActionCount() == 50);
+        CHECK(!set.HasAction("Action0"));
+        CHECK(set.HasAction("Action1"));
+
+        actions.clear();
+        for (int i = 0; i < 50; i++) {
+            const std::string name = "Command" + std::to_string(i);
+            actions.emplace_back(name, MakeAction(name, []() {}));
+        }
+        set.AddActions(actions);
+        CHECK(set.GetActionCount() == 100);
+        CHECK(set.FindVariants("Action0").empty());
+        const std::vector<ActionVariant> found = set.FindVariants("Command7");
+        CHECK(!found.empty() && found.front().actionName == "Command7");
+    }
+
+    void TestStaleHandle() {
+        // handle found before removal must not resolve to action which took the slot later
+        ActionSetFuncPar set;
+        set.AddAction("ExportMesh", []() {});
+        VariantResults results;
+        set.FindVariants("ExportMesh", 10, results);
+        CHECK(results.Size() == 1);
+        const VariantHandle handle = results[0];
+        CHECK(set.GetVariantName(handle, results) == "ExportMesh");
+
+        set.RemoveAction("ExportMesh");
+        set.AddAction("ImportMesh", []() {});
+        CHECK(set.GetVariantName(handle, results).empty());
+        CHECK(set.GetVariantArguments(handle).empty());
+    }
+}
+
+int main() {
+    TestSlotReuse();
+    TestAliasesReleased();
+    TestNameWinsOverAlias();
+    TestExactKeyMovesOnRemove();
+    TestBulkRemoveAndAdd();
+    TestStaleHandle();
+    return CHECK_RESULT();
+}
@@ -0,0 +1,128 @@
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ActionSet.h"
+#include "ActionSetGroup.h"
+#include "Check.h"
+#include "search/SearchBudget.h"
+
+using namespace hotline;
+
+namespace {
+    std::vector<std::string> Names(const ActionSetGroup &group, const VariantResults &results) {
+        std::vector<std::string> names;
+        for (size_t i = 0; i < results.Size(); i++) {
+            names.emplace_back(group.GetVariantName(results[i], results));
+        }
+        return names;
+    }
+
+    std::vector<std::string> Names(const std::vector<ActionVariant> &variants) {
+        std::vector<std::string> names;
+        for (const auto &variant: variants) {
+            names.push_back(variant.actionName);
+        }
+        return names;
+    }
+
+    void FillSet(ActionSet &set, const std::string &prefix, int count) {
+        for (int i = 0; i < count; i++) {
+            set.AddAction(prefix + std::to_string(i), []() {});
+        }
+    }
+
+    void TestBudget() {
+        SearchBudget unlimited;
+        CHECK(unlimited.IsUnlimited());
+        unlimited.Spend(1000000);
+        CHECK(!unlimited.IsExhausted());
+
+        SearchBudget items(10, std::chrono::microseconds(0));
+        CHECK(!items.IsUnlimited());
+        items.Spend(4);
+        CHECK(!items.IsExhausted());
+        items.Spend(100);
+        CHECK(items.IsExhausted());
+    }
+
+    void TestSteps() {
+        ActionSet set;
+        FillSet(set, "Spawn Prop ", 2000);
+        VariantResults results;
+        int steps = 0;
+        bool done = false;
+        while (!done && steps < 1000) {
+            SearchBudget budget(200, std::chrono::microseconds(0));
+            done = set.FindVariantsStep("prop 1999", 5, budget, results);
+            steps++;
+        }
+        CHECK(done);
+        CHECK(steps > 1);
+        const std::vector<ActionVariant> oneShot = set.FindVariants("prop 1999", 5);
+        CHECK(results.Size() == oneShot.size());
+        CHECK(!oneShot.empty() && set.GetVariantName(results[0], results) == oneShot.front().actionName);
+    }
+
+    void TestRestartOnChange() {
+        ActionSet set;
+        FillSet(set, "Spawn Prop ", 2000);
+        VariantResults results;
+        SearchBudget first(200, std::chrono::microseconds(0));
+        CHECK(!set.FindVariantsStep("propx", 3, first, results));
+
+        // added action takes the slot scanned already, it would be missed if search went on
+        set.RemoveAction("Spawn Prop 0");
+        set.AddAction("PropX", []() {});
+        bool done = false;
+        for (int steps = 0; !done && steps < 1000; steps++) {
+            SearchBudget budget(200, std::chrono::microseconds(0));
+            done = set.FindVariantsStep("propx", 3, budget, results);
+        }
+        CHECK(done);
+        CHECK(results.Size() > 0 && set.GetVariantName(results[0], results) == "PropX");
+    }
+
+    void TestGroupRestartOnChange() {
+        auto props = std::make_shared<ActionSet>();
+        FillSet(*props, "Spawn Prop ", 1000);
+        auto lights = std::make_shared<ActionSet>();
+        FillSet(*lights, "Spawn Light ", 1000);
+        ActionSetGroup group;
+        group.AddActionSet("props", props);
+        group.AddActionSet("lights", lights);
+
+        VariantResults results;
+        SearchBudget first(100, std::chrono::microseconds(0));
+        CHECK(!group.FindVariantsStep("spawn 7", 4, first, results));
+
+        lights->RemoveAction("Spawn Light 0");
+        lights->AddAction("Spawn 7", []() {});
+        bool done = false;
+        for (int steps = 0; !done && steps < 1000; steps++) {
+            SearchBudget budget(100, std::chrono::microseconds(0));
+            done = group.FindVariantsStep("spawn 7", 4, budget, results);
+        }
+        CHECK(done);
+        CHECK(Names(group, results) == Names(group.FindVariants("spawn 7", 4)));
+        CHECK(results.Size() > 0 && group.GetVariantName(results[0], results) == "Spawn 7");
+
+        // new query restarts every set
+        done = false;
+        for (int steps = 0; !done && steps < 1000; steps++) {
+            SearchBudget budget(100, std::chrono::microseconds(0));
+            done = group.FindVariantsStep("light 99", 4, budget, results);
+        }
+        CHECK(done);
+        CHECK(Names(group, results) == Names(group.FindVariants("light 99", 4)));
+    }
+}
+
+int main() {
+    TestBudget();
+    TestSteps();
+    TestRestartOnChange();
+    TestGroupRestartOnChange();
+    return CHECK_RESULT();
+}
@@ -0,0 +1,90 @@
+#include <string>
+#include <vector>
+
+#include "ActionSet.h"
+#include "Check.h"
+#include "search/StringPool.h"
+#include "search/VariantResults.h"
+
+using namespace hotline;
+
+namespace {
+    void TestReferences() {
+        StringPool pool;
+        const std::string text = "ReloadShaders";
+        const std::string_view first = pool.Intern(text);
+        const std::string_view second = pool.Intern(std::string("Reload") + "Shaders");
+        CHECK(first == text);
+        CHECK(first.data() == second.data());
+        CHECK(first.data() != text.data());
+        CHECK(pool.GetStringCount() == 1);
+        CHECK(pool.GetByteCount() == text.size());
+
+        pool.Release(first);
+        CHECK(pool.GetStringCount() == 1);
+        CHECK(second == text);
+        pool.Release(second);
+        CHECK(pool.GetStringCount() == 0);
+        CHECK(pool.GetByteCount() == 0);
+    }
+
+    void TestSetReleasesNames() {
+        // names, acronyms and aliases go back to shared pool with their set
+        const size_t before = SharedStringPool().GetStringCount();
+        {
+            ActionSetFuncPar set;
+            set.AddAction("Open Scene Unique41", []() {});
+            set.AddAction("Export Mesh Unique41", []() {});
+            CHECK(set.AddActionAlias("Export Mesh Unique41", "emu41"));
+            CHECK(SharedStringPool().GetStringCount() > before);
+            set.RemoveAction("Export Mesh Unique41");
+        }
+        CHECK(SharedStringPool().GetStringCount() == before);
+    }
+
+    void TestAppendAndSort() {
+        VariantResults first;
+        std::vector<int> &positions = first.BeginHandle();
+        positions.push_back(0);
+        positions.push_back(3);
+        VariantHandle low;
+        low.score = 10;
+        first.AddHandle(low);
+
+        VariantResults second;
+        second.BeginHandle().push_back(5);
+        VariantHandle high;
+        high.score = 20;
+        second.AddHandle(high, "source action");
+        second.BeginHandle();
+        VariantHandle tie;
+        tie.score = 10;
+        second.AddHandle(tie, "tie");
+
+        VariantResults merged;
+        merged.Append(first, 0);
+        merged.Append(second, 1);
+        merged.Sort();
+        CHECK(merged.Size() == 3);
+        // handle keeps its own positions and source name after merge
+        CHECK(merged[0].score == 20 && merged[0].scope == 1);
+        CHECK(merged[0].positionCount == 1 && merged.GetPositions(merged[0])[0] == 5);
+        CHECK(merged.GetSourceName(merged[0]) == "source action");
+        // ties keep scope order
+        CHECK(merged[1].scope == 0 && merged[1].positionCount == 2);
+        CHECK(merged.GetPositions(merged[1])[1] == 3);
+        CHECK(merged[2].scope == 1 && merged.GetSourceName(merged[2]) == "tie");
+
+        merged.Truncate(1);
+        CHECK(merged.Size() == 1);
+        merged.Clear();
+        CHECK(merged.IsEmpty());
+    }
+}
+
+int main() {
+    TestReferences();
+    TestSetReleasesNames();
+    TestAppendAndSort();
+    return CHECK_RESULT();
+}
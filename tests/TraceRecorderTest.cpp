@@ -0,0 +1,105 @@
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "ActionSet.h"
+#include "Check.h"
+#include "TraceRecorder.h"
+
+using namespace hotline;
+
+namespace {
+    std::string Json() {
+        std::ostringstream out;
+        TraceRecorder::Get().WriteJson(out);
+        return out.str();
+    }
+
+    size_t Count(const std::string &text, const std::string &part) {
+        size_t count = 0;
+        for (size_t found = text.find(part); found != std::string::npos; found = text.find(part, found + 1)) {
+            count++;
+        }
+        return count;
+    }
+
+    void TestDisabled() {
+        TraceRecorder &recorder = TraceRecorder::Get();
+        CHECK(!recorder.IsEnabled());
+        recorder.Instant("input", "ignored");
+        CHECK(Json() == "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n]}\n");
+    }
+
+    void TestEvents() {
+        TraceRecorder &recorder = TraceRecorder::Get();
+        recorder.SetEnabled(true);
+        recorder.SetThreadName("main");
+        recorder.Instant("input", "key", "length", 3);
+        recorder.Counter("search", "results", 42);
+        recorder.Complete("action", recorder.Intern("say \"hi\"\n"), 1500, 4000);
+        {
+            ActionSetFunc set;
+            set.AddAction("ReloadShaders", []() {});
+            set.FindVariants("rs");
+        }
+
+        const std::string json = Json();
+        CHECK(json.find("{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"main\"}}")
+              != std::string::npos);
+        CHECK(json.find("\"ph\":\"i\",\"cat\":\"input\",\"name\":\"key\"") != std::string::npos);
+        CHECK(json.find("\"s\":\"t\",\"args\":{\"length\":3}") != std::string::npos);
+        CHECK(json.find("\"ph\":\"C\",\"cat\":\"search\",\"name\":\"results\"") != std::string::npos);
+        CHECK(json.find("\"args\":{\"value\":42}") != std::string::npos);
+        // microsecond timestamps, escaped names
+        CHECK(json.find("\"name\":\"say \\\"hi\\\"\\u000a\",\"pid\":1,\"tid\":1,\"ts\":1.500,\"dur\":2.500}")
+              != std::string::npos);
+        // search spans of the set
+        CHECK(json.find("\"cat\":\"search\",\"name\":\"FindVariants\"") != std::string::npos);
+        CHECK(json.find("\"args\":{\"candidates\":") != std::string::npos);
+        CHECK(json.rfind("\n]}\n") == json.size() - 4);
+    }
+
+    void TestClear() {
+        TraceRecorder &recorder = TraceRecorder::Get();
+        recorder.Clear();
+        std::string json = Json();
+        // thread names are kept, events are not
+        CHECK(Count(json, "\"ph\":") == 1);
+        CHECK(json.find("thread_name") != std::string::npos);
+
+        recorder.Instant("input", "after clear");
+        json = Json();
+        CHECK(Count(json, "\"ph\":") == 2);
+        CHECK(json.find("after clear") != std::string::npos);
+    }
+
+    void TestThreadCapacity() {
+        // only latest events of each thread are kept
+        TraceRecorder &recorder = TraceRecorder::Get();
+        recorder.Clear();
+        recorder.SetThreadCapacity(3);
+        std::thread worker([&recorder]() {
+            recorder.SetThreadName("worker");
+            for (int i = 0; i < 10; i++) {
+                recorder.Instant("worker", "event", "index", i);
+            }
+        });
+        worker.join();
+
+        const std::string json = Json();
+        CHECK(json.find("\"tid\":2,\"args\":{\"name\":\"worker\"}") != std::string::npos);
+        CHECK(Count(json, "\"cat\":\"worker\"") == 4);
+        CHECK(json.find("{\"index\":5}") == std::string::npos);
+        CHECK(json.find("{\"index\":6}") != std::string::npos);
+        CHECK(json.find("{\"index\":9}") != std::string::npos);
+        recorder.SetEnabled(false);
+    }
+}
+
+int main() {
+    TestDisabled();
+    TestEvents();
+    TestClear();
+    TestThreadCapacity();
+    return CHECK_RESULT();
+}
@@ -0,0 +1,80 @@
+#include <string>
+#include <vector>
+
+#include "Check.h"
+#include "search/FuzzyScorer.h"
+#include "search/TypoMatcher.h"
+
+using namespace hotline;
+
+namespace {
+    void TestEditKinds() {
+        TypoMatcher matcher;
+        matcher.SetQuery("shader", 2);
+        CHECK(matcher.IsEnabled());
+
+        TypoMatcher::Match match = matcher.Find("compileshader");
+        CHECK(match.edits == 0);
+        CHECK(match.end == 13);
+
+        CHECK(matcher.Find("reloadshdaer").edits == 1);    // swap of neighbours
+        CHECK(matcher.Find("reloadshadr").edits == 1);     // deletion
+        CHECK(matcher.Find("reloadshadder").edits == 1);   // insertion
+        CHECK(matcher.Find("reloadshaper").edits == 1);    // substitution
+        CHECK(matcher.Find("reloadsaper").edits == 2);
+        CHECK(matcher.Find("texture").edits < 0);
+    }
+
+    void TestEditLimit() {
+        TypoMatcher matcher;
+        // 3 bytes per allowed edit
+        matcher.SetQuery("mesh", 2);
+        CHECK(matcher.GetMaxEdits() == 1);
+        CHECK(matcher.Find("mseh").edits == 1);
+        CHECK(matcher.Find("mxxh").edits < 0);
+
+        matcher.SetQuery("ab", 2);
+        CHECK(!matcher.IsEnabled());
+        CHECK(matcher.Find("ba").edits < 0);
+
+        matcher.SetQuery(std::string(65, 'a'), 2);
+        CHECK(!matcher.IsEnabled());
+    }
+
+    void TestQueryReplaced() {
+        // bytes of previous query must not match anymore
+        TypoMatcher matcher;
+        matcher.SetQuery("export", 1);
+        matcher.SetQuery("import", 1);
+        CHECK(matcher.Find("export").edits < 0);
+        CHECK(matcher.Find("imprt").edits == 1);
+    }
+
+    void TestMayMatch() {
+        TypoMatcher matcher;
+        matcher.SetQuery("shader", 1);
+        const uint64_t queryMask = FuzzyScorer::ComputeCharMask("shader");
+        CHECK(matcher.MayMatch(queryMask, FuzzyScorer::ComputeCharMask("shadr")));
+        CHECK(matcher.MayMatch(queryMask, FuzzyScorer::ComputeCharMask("shaper")));
+        CHECK(!matcher.MayMatch(queryMask, FuzzyScorer::ComputeCharMask("shar")));
+    }
+
+    void TestPositions() {
+        TypoMatcher matcher;
+        matcher.SetQuery("shader", 1);
+        const std::string target = "reloadshadr";
+        const TypoMatcher::Match match = matcher.Find(target);
+        std::vector<int> positions;
+        matcher.GetPositions(target, match, positions);
+        CHECK(positions == std::vector<int>({6, 7, 8, 9, 10}));
+    }
+}
+
+int main() {
+    TestEditKinds();
+    TestEditLimit();
+    TestQueryReplaced();
+    TestMayMatch();
+    TestPositions();
+    return CHECK_RESULT();
+}
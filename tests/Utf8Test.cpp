@@ -0,0 +1,97 @@
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ActionSet.h"
+#include "Check.h"
+#include "search/Utf8.h"
+
+using namespace hotline;
+
+namespace {
+    // text is written with universal character names, so tests don't depend on source encoding
+    std::string Encode(std::u32string_view codePoints) {
+        std::string out;
+        for (const char32_t codePoint: codePoints) {
+            AppendUtf8(out, codePoint);
+        }
+        return out;
+    }
+
+    void TestDecode() {
+        const std::string text = Encode(U"a\u00E9\u0416\u20AC\U0001F600");
+        CHECK(text.size() == 1 + 2 + 2 + 3 + 4);
+        std::u32string decoded;
+        std::vector<int> offsets;
+        DecodeUtf8(text, decoded, &offsets);
+        CHECK(decoded == U"a\u00E9\u0416\u20AC\U0001F600");
+        CHECK(offsets == std::vector<int>({0, 1, 3, 5, 8}));
+        CHECK(NextCodePoint(text, 5) == 8);
+
+        // truncated sequence and stray continuation byte give U+FFFD and advance one byte
+        const std::string malformed = "\xE2\x82" "a\x80";
+        DecodeUtf8(malformed, decoded, &offsets);
+        CHECK(decoded == U"\uFFFD\uFFFDa\uFFFD");
+        CHECK(offsets == std::vector<int>({0, 1, 2, 3}));
+    }
+
+    void TestFoldCase() {
+        CHECK(FoldCase(U'Q') == U'q');
+        CHECK(FoldCase(U'\u00C9') == U'\u00E9');     // E with acute
+        CHECK(FoldCase(U'\u00D7') == U'\u00D7');     // multiplication sign has no lowercase
+        CHECK(FoldCase(U'\u0141') == U'\u0142');     // L with stroke
+        CHECK(FoldCase(U'\u017D') == U'\u017E');     // Z with caron
+        CHECK(FoldCase(U'\u03A3') == U'\u03C3');     // sigma
+        CHECK(FoldCase(U'\u0401') == U'\u0451');     // io
+        CHECK(FoldCase(U'\u0416') == U'\u0436');     // zhe
+        CHECK(FoldCase(U'\u0460') == U'\u0461');     // omega
+        CHECK(FoldCase(U'\u048A') == U'\u048B');     // short i with tail
+        CHECK(FoldCase(U'\u04C0') == U'\u04CF');     // palochka
+        CHECK(FoldCase(U'\u04C1') == U'\u04C2');     // zhe with breve
+        CHECK(FoldCase(U'\u04CD') == U'\u04CE');     // em with tail
+        CHECK(FoldCase(U'\u04D0') == U'\u04D1');     // a with breve
+        CHECK(FoldCase(U'\u04FE') == U'\u04FF');     // ha with stroke
+        CHECK(FoldCase(U'\uFF21') == U'\uFF41');     // fullwidth A
+        // lowercase and uncased code points stay
+        CHECK(FoldCase(U'\u0436') == U'\u0436');
+        CHECK(FoldCase(U'\u04CF') == U'\u04CF');
+        CHECK(FoldCase(U'\u20AC') == U'\u20AC');
+    }
+
+    void TestToLower() {
+        CHECK(ToLower("ExportMesh") == "exportmesh");
+
+        const std::string upper = Encode(U"\u0428\u0415\u0419\u0414\u0415\u0420 Caf\u00C9");
+        const std::string lower = ToLower(upper);
+        CHECK(lower == Encode(U"\u0448\u0435\u0439\u0434\u0435\u0440 caf\u00E9"));
+        // byte offsets of original text stay valid in lowercase text
+        CHECK(lower.size() == upper.size());
+
+        const std::string malformed = "A\xFF" "B";
+        CHECK(ToLower(malformed) == "a\xFF" "b");
+    }
+
+    void TestMatching() {
+        ActionSetFuncPar set;
+        const std::string compile = Encode(U"\u041A\u043E\u043C\u043F\u0438\u043B\u044F\u0446\u0438\u044F");
+        set.AddAction(compile + "Shader", []() {});
+        set.AddAction("CompileShader", []() {});
+
+        // lowercase query finds capitalized Cyrillic name, positions are byte offsets of code points
+        const std::vector<ActionVariant> found = set.FindVariants(Encode(U"\u043A\u043E\u043C\u043F"));
+        CHECK(found.size() == 1);
+        if (!found.empty()) {
+            CHECK(found.front().actionName == compile + "Shader");
+            CHECK(found.front().positions == std::vector<int>({0, 2, 4, 6}));
+        }
+        CHECK(set.FindVariants("compile").size() == 1);
+    }
+}
+
+int main() {
+    TestDecode();
+    TestFoldCase();
+    TestToLower();
+    TestMatching();
+    return CHECK_RESULT();
+}
@@ -0,0 +1,101 @@
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ActionSet.h"
+#include "Check.h"
+#include "search/FuzzyScorer.h"
+#include "search/SearchIndex.h"
+
+using namespace hotline;
+
+namespace {
+    // byte offsets of word starts in name
+    std::vector<int> WordStarts(std::string_view name) {
+        std::vector<uint64_t> bits;
+        FuzzyScorer::ComputeWordStarts(name, bits);
+        std::vector<int> starts;
+        for (int i = 0; i < static_cast<int>(name.size()); i++) {
+            if (FuzzyScorer::IsWordStart(bits.data(), i)) {
+                starts.push_back(i);
+            }
+        }
+        return starts;
+    }
+
+    std::string Acronym(std::string_view name) {
+        std::vector<uint64_t> bits;
+        FuzzyScorer::ComputeWordStarts(name, bits);
+        return FuzzyScorer::ComputeAcronym(name, bits);
+    }
+
+    void TestWordStarts() {
+        CHECK((WordStarts("ReloadShaders") == std::vector<int>{0, 6}));
+        CHECK((WordStarts("open_scene file") == std::vector<int>{0, 5, 11}));
+        CHECK((WordStarts("HTMLParser") == std::vector<int>{0, 4}));
+        CHECK((WordStarts("Export2D") == std::vector<int>{0, 6, 7}));
+        // bitmap covers names longer than one 64-bit word
+        const std::string longName = std::string(70, 'a') + "Tail";
+        CHECK((WordStarts(longName) == std::vector<int>{0, 70}));
+
+        CHECK(Acronym("ReloadShaders") == "rs");
+        CHECK(Acronym("open_scene file") == "osf");
+        CHECK(Acronym("Save").empty());
+    }
+
+    void TestIndexKeepsWordStarts() {
+        // word starts are computed once at registration and give the same score as computed per call
+        SearchIndex index;
+        const SearchIndex::Slot slot = index.Add("ToggleWireframeOverlay");
+        std::string scratch;
+        const SearchIndex::SlotView view = index.GetView(slot, scratch);
+        CHECK(view.wordStarts != nullptr);
+        CHECK(index.GetAcronym(slot) == "two");
+
+        FuzzyScorer scorer;
+        const std::string query = "two";
+        const int precomputed = scorer.GetScore(query, query, 3, view.name, view.lowerName,
+                                                static_cast<int>(view.name.size()), view.isAscii, view.wordStarts);
+        const int computed = scorer.GetScore(query, query, 3, view.name, view.lowerName,
+                                             static_cast<int>(view.name.size()));
+        CHECK(precomputed > 0);
+        CHECK(precomputed == computed);
+    }
+
+    void TestAcronymLookup() {
+        SearchIndex index;
+        const SearchIndex::Slot reload = index.Add("ReloadShaders");
+        const SearchIndex::Slot rename = index.Add("Rename Selection");
+        index.Add("Save");
+        const std::pmr::vector<SearchIndex::Slot> *slots = index.FindAcronym("rs");
+        CHECK(slots != nullptr && slots->size() == 2);
+        CHECK(index.FindAcronym("s") == nullptr);
+
+        index.Remove(reload);
+        slots = index.FindAcronym("rs");
+        CHECK(slots != nullptr && slots->size() == 1 && slots->front() == rename);
+        index.Remove(rename);
+        CHECK(index.FindAcronym("rs") == nullptr);
+    }
+
+    void TestAcronymRank() {
+        // acronym hits rank above subsequence matches with higher score
+        ActionSetFunc set;
+        set.AddAction("Roads", []() {});
+        set.AddAction("ReloadShaders", []() {});
+        const std::vector<ActionVariant> variants = set.FindVariants("rs");
+        CHECK(variants.size() == 2);
+        if (variants.size() == 2) {
+            CHECK(variants[0].actionName == "ReloadShaders" && variants[0].kind == MatchKind::Acronym);
+            CHECK(variants[1].actionName == "Roads" && variants[1].kind == MatchKind::Subsequence);
+        }
+    }
+}
+
+int main() {
+    TestWordStarts();
+    TestIndexKeepsWordStarts();
+    TestAcronymLookup();
+    TestAcronymRank();
+    return CHECK_RESULT();
+}